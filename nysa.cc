@@ -1,342 +1,270 @@
-#include <iostream>
-#include <regex>
-#include <unordered_map>
-#include <vector>
-#include <numeric>
+#include "nysa.h"
 
-namespace logic {
-    /* Sequence of binary digits */
-    using binseq = std::vector<bool>;
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <thread>
 
-    /* Multi-variable logical function */
-    using binfunc = std::function<bool(binseq)>;
+#include <unistd.h>
 
-    /* Abstract functor for logical operations */
-    struct loperator {
-        virtual bool operator()(const binseq& seq) const = 0;
-    };
-
-    struct lnot : public loperator {
-        bool operator()(const binseq& seq) const override {
-            return !seq[0];
+namespace {
+    using namespace nysa;
+
+    /* Reads settings from the command line arguments */
+    std::optional<options> parse_options(int argc, char* argv[]) {
+        options settings;
+
+        for (int i{1}; i < argc; i++) {
+            const std::string option{argv[i]};
+
+            if (option == "--threads" && i + 1 < argc) {
+                const std::string_view count{argv[++i]};
+                const auto [end, status]{std::from_chars(count.data(), count.data() + count.size(),
+                                                         settings.threads)};
+                if (status != std::errc{} || end != count.data() + count.size()
+                    || settings.threads == 0 || settings.threads > max_threads) {
+                    error::print_invalid_option_message(option + " " + std::string{count});
+                    return std::nullopt;
+                }
+            } else if (option == "--workers" && i + 1 < argc) {
+                const std::string_view count{argv[++i]};
+                const auto [end, status]{std::from_chars(count.data(), count.data() + count.size(),
+                                                         settings.workers)};
+                if (status != std::errc{} || end != count.data() + count.size()
+                    || settings.workers == 0 || settings.workers > max_threads) {
+                    error::print_invalid_option_message(option + " " + std::string{count});
+                    return std::nullopt;
+                }
+            } else if (option == "--output" && i + 1 < argc) {
+                settings.output = argv[++i];
+            } else if (option == "--netlist" && i + 1 < argc) {
+                settings.netlist_file = argv[++i];
+            } else if (option == "--gray") {
+                settings.gray = true;
+            } else if (option == "--optimize") {
+                settings.optimize = true;
+            } else if (option == "--aig") {
+                settings.aig = true;
+            } else if (option == "--jit") {
+                settings.jit = true;
+            } else if (option == "--memory-stats") {
+                settings.memory_stats = true;
+            } else if (option == "--checkpoint" && i + 1 < argc) {
+                settings.checkpoint = argv[++i];
+            } else if (option == "--resume") {
+                settings.resume = true;
+            } else if ((option == "--range" || option == "--shard") && i + 1 < argc) {
+                const std::string part{argv[++i]};
+                const auto numbers{parse_number_pair(part, option == "--range" ? ':' : '/')};
+                if (!numbers || (option == "--range" ? numbers->first > numbers->second
+                                                     : numbers->first >= numbers->second)) {
+                    error::print_invalid_option_message(option + " " + part);
+                    return std::nullopt;
+                }
+                (option == "--range" ? settings.range : settings.shard) = numbers;
+            } else if (option == "--perf-counters") {
+                settings.perf_counters = true;
+            } else if (option == "--stats" || option == "--stats=text" || option == "--stats=json") {
+                if (!NYSA_STATS) {
+                    error::print_stats_disabled_message();
+                    return std::nullopt;
+                }
+                settings.stats = option == "--stats=json" ? "json" : "text";
+            } else if (option == "--vectors" && i + 1 < argc) {
+                settings.vectors = argv[++i];
+            } else if (option == "--vector-format" && i + 1 < argc) {
+                const std::string format{argv[++i]};
+                if (format != "text" && format != "binary") {
+                    error::print_invalid_option_message(option + " " + format);
+                    return std::nullopt;
+                }
+                settings.binary_vectors = format == "binary";
+            } else if (option == "--bdd" && i + 1 < argc) {
+                settings.bdd_query = argv[++i];
+                if (settings.bdd_query != "count" && settings.bdd_query != "sat" && settings.bdd_query != "table") {
+                    error::print_invalid_option_message(option + " " + *settings.bdd_query);
+                    return std::nullopt;
+                }
+            } else if (option == "--outputs" && i + 1 < argc) {
+                settings.outputs = parse_signal_list(argv[++i]);
+                if (!settings.outputs) {
+                    error::print_invalid_option_message(option + " " + argv[i]);
+                    return std::nullopt;
+                }
+            } else if (i == 1 && (option == "equiv" || option == "merge" || option == "coordinator")) {
+                settings.command = option;
+            } else if (!settings.command.empty() && settings.command != "coordinator" && !option.starts_with("--")) {
+                settings.operands.push_back(option);
+            } else {
+                error::print_invalid_option_message(option);
+                return std::nullopt;
+            }
         }
 
-        static const std::string name() {
-            return "NOT";
+        if (settings.command == "equiv" && settings.operands.size() != 2) {
+            error::print_invalid_option_message(settings.command + " with " +
+                                                std::to_string(settings.operands.size()) + " netlists");
+            return std::nullopt;
         }
-    };
 
-    struct lxor : public loperator {
-        bool operator()(const binseq& seq) const override {
-            return seq[0] != seq[1];
+        if (settings.command == "merge" && settings.operands.empty()) {
+            error::print_invalid_option_message(settings.command + " without range outputs");
+            return std::nullopt;
         }
 
-        static const std::string name() {
-            return "XOR";
+        if (settings.command == "coordinator" && (settings.vectors || settings.bdd_query)) {
+            error::print_invalid_option_message(settings.command + " without an enumeration");
+            return std::nullopt;
         }
-    };
-
-    struct land : public loperator {
-        bool operator()(const binseq& seq) const override {
-            return std::accumulate(begin(seq), end(seq), true, std::logical_and<>());
+        if (settings.workers != 0 && settings.command != "coordinator") {
+            error::print_invalid_option_message("--workers without coordinator");
+            return std::nullopt;
         }
-
-        static const std::string name() {
-            return "AND";
+        if (settings.command == "coordinator" && settings.workers == 0)
+            settings.workers = std::max(1u, std::thread::hardware_concurrency());
+
+        /* Reports would cover the coordinator process only, not its workers */
+        if (settings.command == "coordinator"
+            && (settings.stats || settings.memory_stats || settings.perf_counters)) {
+            error::print_invalid_option_message(settings.command + " with a report of the run");
+            return std::nullopt;
         }
-    };
 
-    struct lor : public loperator {
-        bool operator()(const binseq& seq) const override {
-            return std::accumulate(begin(seq), end(seq), false, std::logical_or<>());
+        /* Each engine evaluates the whole circuit its own way */
+        if (settings.gray + settings.jit + settings.aig > 1) {
+            error::print_invalid_option_message("more than one of --gray, --jit and --aig");
+            return std::nullopt;
         }
-
-        static const std::string name() {
-            return "OR";
+        if ((settings.gray || settings.jit) && settings.vectors) {
+            error::print_invalid_option_message(std::string{settings.gray ? "--gray" : "--jit"} + " with --vectors");
+            return std::nullopt;
         }
-    };
-
-    struct lnand : public loperator {
-        bool operator()(const binseq& seq) const override {
-            return !land()(seq);
+        if ((settings.gray || settings.jit || settings.aig) && settings.bdd_query) {
+            error::print_invalid_option_message("--bdd with an evaluation engine");
+            return std::nullopt;
         }
 
-        static const std::string name() {
-            return "NAND";
+        if (settings.range && settings.shard) {
+            error::print_invalid_option_message("--range with --shard");
+            return std::nullopt;
         }
-    };
-
-    struct lnor : public loperator {
-        bool operator()(const binseq& seq) const override {
-            return !lor()(seq);
+        if ((settings.range || settings.shard) && (settings.vectors || settings.bdd_query
+                                                   || (!settings.command.empty()
+                                                       && settings.command != "coordinator"))) {
+            error::print_invalid_option_message(std::string{settings.range ? "--range" : "--shard"}
+                                                + " without an enumeration");
+            return std::nullopt;
         }
 
-        static const std::string name() {
-            return "NOR";
-        }
-    };
-
-    /* Factory function for binding name to operator */
-    binfunc operator_of(const std::string& name) {
-        if (name == lnot::name())
-            return lnot();
-        else if (name == lxor::name())
-            return lxor();
-        else if (name == land::name())
-            return land();
-        else if (name == lor::name())
-            return lor();
-        else if (name == lnand::name())
-            return lnand();
-        else if (name == lnor::name())
-            return lnor();
-        throw std::runtime_error("Operator " + name + " does not exist.");
-    }
-
-    std::vector<std::string> unary_names() {
-        return {lnot::name()};
-    }
-
-    std::vector<std::string> binary_names() {
-        return {lxor::name()};
-    }
-
-    std::vector<std::string> multi_names() {
-        return {land::name(), lnand::name(), lor::name(), lnor::name()};
-    }
-}
-
-namespace {
-
-    /* Signal index */
-    using sig_t = int32_t;
-
-    /* Sequence of signal indexes */
-    using sigvector = std::vector<sig_t>;
-
-    /* Generic mapping of signal indexes */
-    template<typename T>
-    using sigmap = std::map<sig_t, bool>;
-
-    /* Information for logical processing of a gate */
-    using gate_input = std::pair<logic::binfunc, sigvector>;
-
-    /* Graph representing the circuit of all logical gates */
-    using gate_graph = std::unordered_map<sig_t, gate_input>;
-
-    namespace error {
-        void print_invalid_parsing_message(uint64_t line, const std::string &info) {
-            std::cerr << "Error in line " << line << ": " << info << std::endl;
+        /* Progress is kept only for enumerations written to a file */
+        if (settings.resume && !settings.checkpoint) {
+            error::print_invalid_option_message("--resume without --checkpoint");
+            return std::nullopt;
         }
-
-        void print_repetitive_output_message(uint16_t line, sig_t signal) {
-            std::cerr << "Error in line " << line << ": " << "signal " << signal
-                      << " is assigned to multiple outputs." << std::endl;
+        if (settings.checkpoint && (!settings.output || settings.vectors || settings.bdd_query
+                                    || (!settings.command.empty() && settings.command != "coordinator"))) {
+            error::print_invalid_option_message("--checkpoint without an enumeration written to --output");
+            return std::nullopt;
         }
 
-        void print_circuit_cycle_message() {
-            std::cerr << "Error: sequential logic analysis "
-                      << "has not yet been implemented." << std::endl;
-        }
+        return settings;
     }
+}
 
+int main(int argc, char* argv[]) {
+    const auto settings{parse_options(argc, argv)};
+    if (!settings)
+        return EXIT_FAILURE;
 
-    /* Transforms a sequence of strings to a choice regex pattern. */
-    std::string pattern_of(const std::vector<std::string>& names) {
-        const auto prefix{"\\s*("};
-        const auto postfix{")(\\s+[1-9]\\d{0,8})"};
-
-        if (names.size() == 1)
-            return prefix + names[0] + postfix;
-
-        std::string infix;
-
-        for (size_t i{0}; i < names.size(); i++) {
-            infix += "(" + names[i] + ")";
-            if (i != names.size() - 1)
-                infix += "|";
-        }
-
-        return prefix + infix + postfix;
-    }
-
-    /* Validation of correct representation of an input line. */
-    bool is_valid_input(const std::string& input) {
-        const std::vector<std::regex> regexes = {
-                std::regex{pattern_of(logic::unary_names()) + "{2}\\s*"},
-                std::regex{pattern_of(logic::binary_names()) + "{3}\\s*"},
-                std::regex{pattern_of(logic::multi_names()) + "{3,}\\s*"}
-        };
+    std::optional<memory_report> report;
+    if (settings->memory_stats)
+        report.emplace();
 
-        return std::any_of(begin(regexes), end(regexes), [&](const auto& pattern) {
-            return std::regex_match(input, pattern);
-        });
-    }
+    std::optional<stats_report> stats;
+    if (settings->stats)
+        stats.emplace(*settings->stats == "json");
 
-    /* Extracts the name of a gate and the signals. Assumption: input is valid. */
-    std::pair<std::string, std::string> split_by_name(const std::string &input) {
-        size_t div_pos{0};
-        size_t name_start{SIZE_MAX};
+    std::optional<perf_report> counters;
+    if (settings->perf_counters)
+        counters.emplace();
 
-        while (!isalpha(input[div_pos]) || isalpha(input[div_pos + 1])) {
-            if (isalpha(input[div_pos]) && name_start == SIZE_MAX)
-                name_start = div_pos;
+    /* Range outputs are all checked before the output is created */
+    if (settings->command == "merge")
+        return merge_range_outputs(*settings);
 
-            div_pos++;
+    if (settings->command == "equiv") {
+        auto output{settings->output ? output_writer{*settings->output} : output_writer{}};
+        if (!output.is_open()) {
+            error::print_output_file_message(*settings->output);
+            return EXIT_FAILURE;
         }
-
-        auto name{input.substr(name_start, div_pos + 1 - name_start)};
-        auto signals{input.substr(div_pos + 1, input.size() - div_pos - 1)};
-
-        return {name, signals};
-    }
-
-    /* Transforms string-represented signals to a separate output and inputs */
-    std::pair<sigvector, sig_t> parse_signals(const std::string &signals) {
-        sig_t output;
-        sigvector inputs{};
-        std::istringstream sigstream{signals};
-
-        sigstream >> output;
-        for (sig_t signal; sigstream >> signal;)
-            inputs.push_back(signal);
-
-        return {inputs, output};
+        return check_equivalence(*settings, output);
     }
 
-    /* Visits a node in graph representing the logical gate
-     * system in order to sort it topologically */
-    void visit_gate(sig_t output, const gate_graph& circuit,
-                    sigvector& order, sigmap<bool>& visited) {
-        if (visited.contains(output) && visited.at(output))
-            return;
+    std::optional<mapped_file> mapping;
+    std::string text;
 
-        if (visited.contains(output) && !visited.at(output)) {
-            error::print_circuit_cycle_message();
-            exit(EXIT_FAILURE);
+    if (settings->netlist_file) {
+        const scoped_timer timer{phase::read};
+        mapping.emplace(*settings->netlist_file);
+        if (!mapping->is_open()) {
+            error::print_netlist_file_message(*settings->netlist_file);
+            return EXIT_FAILURE;
         }
-
-        visited[output] = false;
-
-        /* Recursive visiting of the neighbouring nodes */
-        if (circuit.contains(output)) {
-            const auto &inputs{circuit.at(output).second};
-            std::for_each(begin(inputs), end(inputs), [&](sig_t input) {
-                visit_gate(input, circuit, order, visited);
-            });
-        }
-
-        visited[output] = true;
-        order.push_back(output);
-    }
-
-    /* Produces an order in which gates must be computed */
-    sigvector get_signal_evaluation_order(const gate_graph& circuit) {
-        sigvector order;
-        sigmap<bool> visited;
-
-        /* Topological sort */
-        std::for_each(begin(circuit), end(circuit), [&](auto entry) {
-            const auto& output{entry.first};
-            if (!visited.contains(output) || !visited.at(output))
-                visit_gate(output, circuit, order, visited);
-        });
-
-        /* Moving leaf-nodes to the left */
-        std::sort(begin(order), end(order), [&](sig_t sigl, sig_t sigr) {
-            return !circuit.contains(sigl) && circuit.contains(sigr);
-        });
-
-        return order;
-    }
-
-    /* Counts independent input signals in gate system */
-    size_t count_inputs(const gate_graph &circuit, const sigvector& order) {
-        return std::count_if(begin(order), end(order), [&](sig_t signal) {
-            return !circuit.contains(signal);
-        });
-    }
-
-    /* Evaluates an output for a specified signal input in the circuit */
-    bool compute_gate(const gate_input& gate_in, sigmap<bool> &values) {
-        logic::binseq input_values;
-        const auto& inputs{gate_in.second};
-
-        std::for_each(begin(inputs), end(inputs), [&](sig_t input) {
-            input_values.push_back(values[input]);
-        });
-
-        return gate_in.first(input_values);
+    } else {
+        const scoped_timer timer{phase::read};
+        text = read_all(STDIN_FILENO);
     }
 
-    /* Displays output for a single combination of input signals */
-    void print_circuit_output(const gate_graph& circuit, sigmap<bool>& values,
-                              const sigvector& order, size_t input_size) {
-        auto start{std::next(begin(order), static_cast<int32_t>(input_size))};
-
-        std::for_each(start, end(order), [&](sig_t signal) {
-            if (circuit.contains(signal)) {
-                const auto &outputs{circuit.at(signal)};
-                values[signal] = compute_gate(outputs, values);
-            }
-        });
+    gate_graph circuit;
+    const bool error_occurred{!parse_netlist(mapping ? mapping->text() : text, settings->threads, circuit)};
 
-        for (const auto& [_, value] : values)
-            std::cout << value;
-        std::cout << std::endl;
+    std::optional<sigvector> selection;
+    if (!error_occurred && settings->outputs) {
+        selection = select_signals(circuit, *settings->outputs);
+        if (!selection)
+            return EXIT_FAILURE;
     }
 
-    /* Displays complete circuit output list */
-    void print_all_circuit_outputs(const gate_graph& circuit) {
-        sigvector order{get_signal_evaluation_order(circuit)};
-
-        const auto input_count{count_inputs(circuit, order)};
-        const auto combinations{1L << input_count};
-
-        /* Sort independent inputs by ascending order */
-        auto input_end{std::next(begin(order), static_cast<int32_t>(input_count))};
-        std::sort(begin(order), input_end, std::greater<>());
-
-        sigmap<bool> values;
-        for (size_t input{0}; input < static_cast<size_t>(combinations); input++) {
-            size_t input_ordinal = input;
-
-            /* Convert a number to a binary sequence of a signal values */
-            for (size_t bit{0}; bit < input_count; bit++) {
-                auto sig_val{static_cast<bool>(input_ordinal % 2)};
-                values[order[bit]] = sig_val;
-                input_ordinal /= 2;
+    /* Hash of the netlist shared by all parts of its enumeration */
+    uint64_t identity{0};
+    if (!error_occurred && (settings->checkpoint || settings->range || settings->shard))
+        identity = run_hash(mapping ? mapping->text() : text, settings->outputs);
+
+    std::optional<checkpoint_writer> progress;
+    if (!error_occurred && settings->checkpoint) {
+        checkpoint state{hash_bytes(part_description(*settings), identity)};
+        if (settings->resume) {
+            const auto saved{read_checkpoint(*settings->checkpoint)};
+            if (!saved) {
+                error::print_checkpoint_file_message(*settings->checkpoint);
+                return EXIT_FAILURE;
             }
-
-            print_circuit_output(circuit, values, order, input_count);
-        }
-    }
-}
-
-int main() {
-    gate_graph circuit;
-    std::string gate_info;
-    bool error_occurred = false;
-
-    for (uint64_t line{1}; std::getline(std::cin, gate_info); line++) {
-        if (is_valid_input(gate_info)) {
-            auto [name, signals]{split_by_name(gate_info)};
-            auto [input, output]{parse_signals(signals)};
-
-            if (!circuit.contains(output)) {
-                circuit[output] = {logic::operator_of(name), input};
-            } else {
-                error::print_repetitive_output_message(line, output);
-                error_occurred |= true;
+            if (saved->netlist_hash != state.netlist_hash) {
+                error::print_checkpoint_mismatch_message(*settings->checkpoint);
+                return EXIT_FAILURE;
             }
-        } else {
-            error::print_invalid_parsing_message(line, gate_info);
-            error_occurred |= true;
+            state = *saved;
         }
+        progress.emplace(*settings->checkpoint, state);
     }
 
     if (!error_occurred) {
-        print_all_circuit_outputs(circuit);
+        auto output{!settings->output ? output_writer{}
+                    : settings->resume ? output_writer{*settings->output, progress->progress().output_offset}
+                    : output_writer{*settings->output}};
+        if (!output.is_open()) {
+            error::print_output_file_message(*settings->output);
+            return EXIT_FAILURE;
+        }
+        const auto compiled{prepare_circuit(circuit, selection, *settings)};
+        statistics().gates = compiled.gates.size();
+
+        const auto succeeded{settings->bdd_query ? print_bdd_outputs(compiled, *settings, output)
+                             : settings->vectors ? print_vector_outputs(circuit, compiled, *settings, output)
+                             : print_all_circuit_outputs(compiled, *settings, output, identity,
+                                                         progress ? &*progress : nullptr)};
+        return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
     return (error_occurred ? EXIT_FAILURE : EXIT_SUCCESS);
@@ -0,0 +1,482 @@
+#ifndef NYSA_H
+#define NYSA_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/* Timers and counters behind --stats, compiled out when zero */
+#ifndef NYSA_STATS
+#define NYSA_STATS 1
+#endif
+
+namespace logic {
+    /* Word of binary digits, one digit per evaluated combination */
+    using binword = uint64_t;
+
+    /* Number of words evaluated together by a single kernel call */
+    constexpr size_t block_words{8};
+
+    /* Block of binary words, as wide as the widest vector register */
+    using binblock = std::array<binword, block_words>;
+
+    /* Index of a block holding a signal value in the compiled circuit */
+    using slot_t = uint32_t;
+
+    /* Kinds of logical operations, used to dispatch compiled gates */
+    enum class opcode : uint8_t { lnot, lxor, land, lor, lnand, lnor };
+
+    /* Number of distinct opcodes */
+    constexpr size_t opcode_count{6};
+
+    /* Compact record of a gate in the compiled circuit */
+    struct gate_record {
+        opcode op;
+        uint32_t fanin_offset;
+        uint32_t fanin_count;
+        slot_t output;
+    };
+
+    /* Kernels evaluating the gates of a circuit on blocks, selected at runtime
+     * according to the vector extensions supported by the processor */
+    namespace simd {
+        /* Computes a run of gates in order, reading and writing the blocks of slots */
+        using gates_kernel = void (*)(binblock* slots, const gate_record* gates, size_t count,
+                                      const slot_t* fanins);
+
+        /* Computes AND nodes of complemented-edge literals, the lowest bit of
+         * a literal negating the slot in its remaining bits: node k reads
+         * literals nodes[2k] and nodes[2k + 1] and writes slot first + k */
+        using and_kernel = void (*)(binblock* slots, const uint32_t* nodes, size_t count, slot_t first);
+
+        /* Kernels of a single instruction set */
+        struct kernel_table {
+            const char* name;
+            gates_kernel gates;
+            and_kernel conjunctions;
+        };
+
+        /* Picks the widest kernels the processor is able to execute */
+        const kernel_table& kernels();
+    }
+}
+
+namespace nysa {
+
+    /* Signal index */
+    using sig_t = int32_t;
+
+    /* Sequence of signal indexes */
+    using sigvector = std::vector<sig_t>;
+
+    /* Information for logical processing of a gate */
+    using gate_input = std::pair<logic::opcode, std::span<const sig_t>>;
+
+    /* Gate driving a signal, its inputs being a range of the fan-in array.
+     * Independent inputs are the signals without any input of their own. */
+    struct gate_entry {
+        logic::opcode op;
+        uint32_t fanin_offset;
+        uint32_t fanin_count;
+    };
+
+    /* Graph representing the circuit of all logical gates. Signals are
+     * renumbered densely in order of appearance; the identifiers from the
+     * input are kept only as labels for displaying the output. Inputs of all
+     * gates are packed in a single array, and the nodes of the identifier map
+     * come from an arena released at once with the graph. */
+    struct gate_graph {
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> arena{
+                std::make_unique<std::pmr::monotonic_buffer_resource>()};
+        std::vector<gate_entry> gates;
+        sigvector fanins;
+        sigvector labels;
+        std::pmr::unordered_map<sig_t, sig_t> indexes{arena.get()};
+
+        /* Dense index of a signal identifier, assigned on first use */
+        sig_t index_of(sig_t label);
+
+        /* Defines the gate of a signal over the given input signals */
+        void add_gate(sig_t signal, logic::opcode op, std::span<const sig_t> inputs);
+
+        size_t size() const;
+
+        bool contains(sig_t signal) const;
+
+        gate_input at(sig_t signal) const;
+    };
+
+    /* Circuit flattened into gates stored in evaluation order. Input signals
+     * occupy the leading slots, slot i holding bit i of the input ordinal.
+     * Gates of logic level l + 1 occupy range [level_offsets[l], level_offsets[l + 1]). */
+    struct netlist {
+        std::vector<logic::gate_record> gates;
+        std::vector<uint32_t> level_offsets;
+        std::vector<logic::slot_t> fanins;
+        std::vector<logic::slot_t> columns;
+        sigvector column_labels;
+        sigvector labels;
+        size_t input_count;
+    };
+
+    namespace error {
+        void print_invalid_option_message(const std::string& option);
+
+        void print_output_file_message(const std::string& path);
+
+        void print_netlist_file_message(const std::string& path);
+
+        void print_checkpoint_file_message(const std::string& path);
+
+        void print_checkpoint_mismatch_message(const std::string& path);
+
+        void print_stats_disabled_message();
+    }
+
+    /* Phases of a run timed separately by --stats */
+    enum class phase : uint8_t { read, parse, compile, evaluate, format, write };
+
+    constexpr std::array<const char*, 6> phase_names{"read", "parse", "compile", "evaluate", "format", "write"};
+
+    /* Times and counts accumulated by all threads of a run. Times of a
+     * phase running on several threads add up over the threads. */
+    struct run_statistics {
+        bool enabled{false};
+        std::array<std::atomic<uint64_t>, phase_names.size()> wall_nanoseconds{};
+        std::array<std::atomic<uint64_t>, phase_names.size()> cpu_nanoseconds{};
+        std::atomic<uint64_t> rows{0};
+        std::atomic<uint64_t> bytes_written{0};
+        /* Evaluations of a gate, or of a node of an and-inverter graph, for
+         * one combination, counted where they happen: every lane of a block,
+         * or only the gates reached by an event in Gray-code order */
+        std::atomic<uint64_t> gate_evaluations{0};
+        uint64_t gates{0};
+    };
+
+    run_statistics& statistics();
+
+    uint64_t clock_nanoseconds(clockid_t clock);
+
+    /* Adds the wall and thread CPU time until the end of its scope to a
+     * phase, when statistics are being recorded */
+    class scoped_timer {
+    public:
+        explicit scoped_timer(phase measured);
+#if NYSA_STATS
+        ~scoped_timer();
+#endif
+
+        scoped_timer(const scoped_timer&) = delete;
+        scoped_timer& operator=(const scoped_timer&) = delete;
+
+#if NYSA_STATS
+    private:
+        phase measured;
+        bool active;
+        uint64_t wall{0};
+        uint64_t cpu{0};
+#endif
+    };
+
+    /* Parses a netlist on a pool of threads, each taking a range of whole
+     * lines, then merges the gates into the circuit in line order. Errors are
+     * displayed in line order as well. Returns false if any error occurred. */
+    bool parse_netlist(std::string_view text, size_t thread_count, gate_graph& circuit);
+
+    /* Read-only memory mapping of a whole file */
+    class mapped_file {
+    public:
+        explicit mapped_file(const std::string& path);
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        ~mapped_file();
+
+        bool is_open() const;
+
+        std::string_view text() const;
+
+    private:
+        void* data{nullptr};
+        size_t size{0};
+        bool valid{false};
+    };
+
+    /* Reads the whole content of a file descriptor */
+    std::string read_all(int descriptor);
+
+    /* Number of input combinations evaluated in a single word */
+    constexpr size_t word_lanes{64};
+
+    /* Number of input combinations evaluated in a single pass */
+    constexpr size_t block_lanes{word_lanes * logic::block_words};
+
+    /* Translates the circuit to a flat array of gates in evaluation order. If
+     * signals are selected, only their cones and the retained signals are kept
+     * and only the selected ones are displayed, in the order of selection;
+     * otherwise all signals are displayed. */
+    netlist compile_circuit(const gate_graph& circuit, const std::optional<sigvector>& selection,
+                            const sigvector& retained = {});
+
+    /* Assigns a block of consecutive combinations starting at an input ordinal */
+    void assign_inputs(const netlist& compiled, std::vector<logic::binblock>& values, size_t input);
+
+    /* Evaluates all gates for a block of combinations of input signals */
+    void compute_gates(const netlist& compiled, std::vector<logic::binblock>& values);
+
+    /* Writes rows of a block of combinations to a buffer with rows of fixed
+     * width, converting packed bits to digits one column at a time */
+    void format_block(const netlist& compiled, const std::vector<logic::binblock>& values,
+                      size_t rows, char* buffer);
+
+    /* Settings given on the command line */
+    struct options {
+        size_t threads{1};
+        std::optional<std::string> output;
+        std::optional<std::string> netlist_file;
+        bool gray{false};
+        bool optimize{false};
+        bool aig{false};
+        bool jit{false};
+        bool memory_stats{false};
+        std::optional<std::string> stats;
+        bool perf_counters{false};
+        std::optional<std::string> checkpoint;
+        bool resume{false};
+        std::optional<std::pair<uint64_t, uint64_t>> range;
+        std::optional<std::pair<uint64_t, uint64_t>> shard;
+        size_t workers{0};
+        std::optional<sigvector> outputs;
+        std::optional<std::string> vectors;
+        bool binary_vectors{false};
+        std::optional<std::string> bdd_query;
+        std::string command;
+        std::vector<std::string> operands;
+    };
+
+    /* Compiles the circuit, reducing it first if requested */
+    netlist prepare_circuit(const gate_graph& circuit, const std::optional<sigvector>& selection,
+                            const options& settings);
+
+    /* Destination of the circuit output, written in large blocks */
+    class output_writer {
+    public:
+        output_writer();
+
+        explicit output_writer(const std::string& path);
+
+        /* Continues a file from an offset, dropping anything written after it */
+        output_writer(const std::string& path, uint64_t offset);
+
+        output_writer(const output_writer&) = delete;
+        output_writer& operator=(const output_writer&) = delete;
+
+        ~output_writer();
+
+        bool is_open() const;
+
+        /* Offset of the end of the output in the file */
+        uint64_t position() const;
+
+        /* Waits until everything written is stored, returning whether it is */
+        bool sync() const;
+
+        /* Returns false, having reported it, if the output cannot be written */
+        bool write(std::string_view data);
+
+    private:
+        int descriptor;
+        bool owned;
+        uint64_t written{0};
+    };
+
+    /* FNV-1a hash of a sequence of bytes, continuing from a previous hash */
+    uint64_t hash_bytes(std::string_view data, uint64_t hash = 0xCBF29CE484222325);
+
+    /* Hash identifying the output of an enumeration: the netlist text and
+     * the signals selected for display */
+    uint64_t run_hash(std::string_view text, const std::optional<sigvector>& selection);
+
+    /* Progress of an enumeration: its output is complete for the
+     * combinations before an ordinal and ends at an offset of the file */
+    struct checkpoint {
+        uint64_t netlist_hash{0};
+        uint64_t next_ordinal{0};
+        uint64_t output_offset{0};
+    };
+
+    /* Reads progress saved as lines of a name and a number */
+    std::optional<checkpoint> read_checkpoint(const std::string& path);
+
+    /* Saves the progress of an enumeration from time to time. The output is
+     * stored before the progress that refers to it, and the progress file is
+     * replaced at once, so a crash leaves a consistent pair behind. */
+    class checkpoint_writer {
+    public:
+        checkpoint_writer(std::string path, const checkpoint& state);
+
+        const checkpoint& progress() const;
+
+        /* Records that the output is complete before an ordinal, saving
+         * the progress when due or when the enumeration is finished. Returns
+         * false, having reported it, if the output cannot be stored, in which
+         * case the progress is not saved, or if the progress cannot be saved;
+         * the enumeration is then to be stopped. */
+        bool advance(uint64_t next_ordinal, const output_writer& output, bool finished);
+
+    private:
+        std::string path;
+        checkpoint state;
+        std::chrono::steady_clock::time_point saved;
+    };
+
+    /* Description of the part enumerated by a run, distinguishing the
+     * progress of runs over different parts */
+    std::string part_description(const options& settings);
+
+    /* Displays complete circuit output list, or the part of it selected by
+     * a range or a shard after a header naming the part. A run continued
+     * from saved progress starts where the previous one stopped. */
+    bool print_all_circuit_outputs(const netlist& compiled, const options& settings, output_writer& output,
+                                   uint64_t netlist_hash = 0, checkpoint_writer* progress = nullptr);
+
+    /* Simulates the circuit for input vectors read from a file instead of
+     * enumerating all combinations. A vector lists the values of all
+     * independent inputs by ascending identifier, either as a line of digits
+     * (blanks are ignored, blank lines skipped) or packed into bytes, lowest
+     * bit first. Vectors are packed into blocks of lanes as they arrive, so
+     * memory stays bounded whatever the number of vectors. Output already
+     * written when an invalid vector is found is kept and reported; rows
+     * still buffered are dropped. */
+    bool print_vector_outputs(const gate_graph& circuit, const netlist& compiled,
+                              const options& settings, output_writer& output);
+
+    /* Builds decision diagrams of the displayed signals gate by gate and
+     * answers queries about them without enumerating the combinations: the
+     * number of satisfying combinations, a single satisfying combination, or
+     * a truth table compressed into disjoint cubes. Combinations list the
+     * values of inputs by ascending identifier, '-' meaning either value. */
+    bool print_bdd_outputs(const netlist& compiled, const options& settings, output_writer& output);
+
+    /* Hardware event counted by the kernel */
+    struct counted_event {
+        uint32_t type;
+        uint64_t config;
+    };
+
+    /* Counts hardware events in user space through the performance counters
+     * of the kernel, for the whole process including threads started later
+     * or only for the calling thread when not inherited. The events form a
+     * group scheduled on the processor together; the first one leads the
+     * group and the others are counted only with it. */
+    class counter_group {
+    public:
+        explicit counter_group(const std::vector<counted_event>& events, bool enabled = true,
+                               bool inherited = true);
+
+        counter_group(const counter_group&) = delete;
+        counter_group& operator=(const counter_group&) = delete;
+
+        ~counter_group();
+
+        /* Starts or stops counting all events of the group */
+        void enable(bool enabled) const;
+
+        /* Counts of the events so far, missing for events that could not
+         * be opened or were never scheduled on the processor */
+        std::vector<std::optional<uint64_t>> read() const;
+
+    private:
+        static int open_counter(const counted_event& event, int leader, bool enabled, bool inherited);
+
+        std::vector<int> descriptors;
+    };
+
+    /* Reports the peak resident memory and the cache miss rate of the run
+     * on the standard error stream when destroyed */
+    class memory_report {
+    public:
+        memory_report();
+        memory_report(const memory_report&) = delete;
+        memory_report& operator=(const memory_report&) = delete;
+
+        ~memory_report();
+
+    private:
+        counter_group counter;
+    };
+
+    /* Counts hardware events on every thread while it evaluates gates, and
+     * reports them on the standard error stream when destroyed, in total,
+     * per gate evaluated for one combination and per output row */
+    class perf_report {
+    public:
+        perf_report();
+
+        perf_report(const perf_report&) = delete;
+        perf_report& operator=(const perf_report&) = delete;
+
+        ~perf_report();
+    };
+
+    /* Reports the time of every phase of the run, its throughput, the
+     * amount of output and the peak resident memory on the standard error
+     * stream when destroyed, as text or as a JSON object */
+    class stats_report {
+    public:
+        explicit stats_report(bool json);
+
+        stats_report(const stats_report&) = delete;
+        stats_report& operator=(const stats_report&) = delete;
+
+        ~stats_report();
+
+    private:
+        bool json;
+        uint64_t wall;
+        uint64_t cpu;
+    };
+
+    /* Largest accepted number of worker threads */
+    constexpr size_t max_threads{9999};
+
+    /* Reads a comma-separated list of signal identifiers */
+    std::optional<sigvector> parse_signal_list(std::string_view list);
+
+    /* Reads two decimal numbers joined by a separator */
+    std::optional<std::pair<uint64_t, uint64_t>> parse_number_pair(std::string_view text, char separator);
+
+    /* Finds the signals of the given identifiers in the circuit */
+    std::optional<sigvector> select_signals(const gate_graph& circuit, const sigvector& labels);
+
+    /* Decides whether two netlists compute the same functions. Compared are
+     * the signals given with --outputs or else the primary outputs, which must
+     * be the same in both; inputs are matched by identifier. Both netlists
+     * are first simulated on random blocks of combinations, then the miter
+     * of the remaining candidates is handed to the SAT solver. */
+    int check_equivalence(const options& settings, output_writer& output);
+
+    /* Concatenates the outputs of ranges into the output of all
+     * combinations, without their headers. The ranges must belong to the
+     * same netlist, follow each other from the first combination to the
+     * last in the given order and hold a row for every combination. Nothing
+     * is written unless all of them do; an output file is written under a
+     * temporary name and renamed once complete, and may not be one of the
+     * ranges. */
+    int merge_range_outputs(const options& settings);
+}
+
+#endif
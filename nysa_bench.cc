@@ -0,0 +1,333 @@
+#include "nysa.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <tuple>
+
+namespace {
+    using namespace nysa;
+
+    /* Writer of the netlist text of a generated circuit, numbering
+     * signals consecutively from one */
+    class circuit_writer {
+    public:
+        sig_t input() {
+            inputs++;
+            return next++;
+        }
+
+        sig_t gate(const std::string& name, const sigvector& operands) {
+            text += name + " " + std::to_string(next);
+            for (const auto operand : operands)
+                text += " " + std::to_string(operand);
+            text += "\n";
+            gates++;
+            return next++;
+        }
+
+        /* Sum and carry of three bits */
+        std::pair<sig_t, sig_t> full_adder(sig_t lhs, sig_t rhs, sig_t carry) {
+            const auto half{gate("XOR", {lhs, rhs})};
+            const auto sum{gate("XOR", {half, carry})};
+            return {sum, gate("OR", {gate("AND", {lhs, rhs}), gate("AND", {half, carry})})};
+        }
+
+        std::string text;
+        size_t inputs{0};
+        size_t gates{0};
+
+    private:
+        sig_t next{1};
+    };
+
+    sigvector make_inputs(circuit_writer& writer, size_t count) {
+        sigvector signals(count);
+        std::generate(begin(signals), end(signals), [&] { return writer.input(); });
+        return signals;
+    }
+
+    /* Adder propagating the carry through every bit */
+    circuit_writer ripple_adder(size_t bits) {
+        circuit_writer writer;
+        const auto lhs{make_inputs(writer, bits)};
+        const auto rhs{make_inputs(writer, bits)};
+        auto carry{writer.input()};
+
+        for (size_t bit{0}; bit < bits; bit++)
+            carry = writer.full_adder(lhs[bit], rhs[bit], carry).second;
+        return writer;
+    }
+
+    /* Adder computing the carries of groups of four bits from generate and
+     * propagate signals, groups being chained by their carries */
+    circuit_writer lookahead_adder(size_t bits) {
+        constexpr size_t group_bits{4};
+        circuit_writer writer;
+        const auto lhs{make_inputs(writer, bits)};
+        const auto rhs{make_inputs(writer, bits)};
+        auto carry{writer.input()};
+
+        for (size_t first{0}; first < bits; first += group_bits) {
+            const auto last{std::min(bits, first + group_bits)};
+            sigvector generate;
+            sigvector propagate;
+            for (auto bit{first}; bit < last; bit++) {
+                generate.push_back(writer.gate("AND", {lhs[bit], rhs[bit]}));
+                propagate.push_back(writer.gate("XOR", {lhs[bit], rhs[bit]}));
+            }
+
+            /* Carry into bit k: some lower bit generates one that all bits between propagate */
+            sigvector carries{carry};
+            for (size_t k{1}; k <= last - first; k++) {
+                sigvector terms;
+                for (size_t j{0}; j <= k; j++) {
+                    sigvector factors{j == 0 ? carry : generate[j - 1]};
+                    factors.insert(end(factors), std::next(begin(propagate), static_cast<ptrdiff_t>(j)),
+                                   std::next(begin(propagate), static_cast<ptrdiff_t>(k)));
+                    terms.push_back(factors.size() == 1 ? factors[0] : writer.gate("AND", factors));
+                }
+                carries.push_back(writer.gate("OR", terms));
+            }
+
+            for (size_t k{0}; k < last - first; k++)
+                writer.gate("XOR", {propagate[k], carries[k]});
+            carry = carries.back();
+        }
+        return writer;
+    }
+
+    /* Multiplier adding the rows of partial products with ripple adders */
+    circuit_writer array_multiplier(size_t bits) {
+        circuit_writer writer;
+        const auto lhs{make_inputs(writer, bits)};
+        const auto rhs{make_inputs(writer, bits)};
+
+        sigvector sum;
+        for (size_t i{0}; i < bits; i++)
+            sum.push_back(writer.gate("AND", {lhs[i], rhs[0]}));
+
+        for (size_t row{1}; row < bits; row++) {
+            /* Bits below the row are final, the rest are added to the next partial products */
+            sigvector next;
+            sig_t carry{0};
+            for (size_t i{0}; i < bits; i++) {
+                const auto product{writer.gate("AND", {lhs[i], rhs[row]})};
+                const auto addend{i + 1 < sum.size() ? sum[i + 1] : 0};
+                sig_t bit;
+                if (addend == 0 && carry == 0) {
+                    bit = product;
+                } else if (addend == 0 || carry == 0) {
+                    const auto other{addend == 0 ? carry : addend};
+                    bit = writer.gate("XOR", {product, other});
+                    carry = writer.gate("AND", {product, other});
+                    next.push_back(bit);
+                    continue;
+                } else {
+                    std::tie(bit, carry) = writer.full_adder(product, addend, carry);
+                }
+                next.push_back(bit);
+            }
+            if (carry != 0)
+                next.push_back(carry);
+            sum = std::move(next);
+        }
+        return writer;
+    }
+
+    /* Balanced tree of XOR gates over all inputs */
+    circuit_writer parity_tree(size_t input_count) {
+        circuit_writer writer;
+        auto level{make_inputs(writer, input_count)};
+
+        while (level.size() > 1) {
+            sigvector next;
+            for (size_t i{0}; i + 1 < level.size(); i += 2)
+                next.push_back(writer.gate("XOR", {level[i], level[i + 1]}));
+            if (level.size() % 2 != 0)
+                next.push_back(level.back());
+            level = std::move(next);
+        }
+        return writer;
+    }
+
+    /* Multiplexer selecting one of the data inputs by a binary index */
+    circuit_writer multiplexer(size_t select_bits) {
+        circuit_writer writer;
+        const auto select{make_inputs(writer, select_bits)};
+        const auto data{make_inputs(writer, size_t{1} << select_bits)};
+
+        sigvector inverted;
+        for (const auto bit : select)
+            inverted.push_back(writer.gate("NOT", {bit}));
+
+        sigvector terms;
+        for (size_t index{0}; index < data.size(); index++) {
+            sigvector factors{data[index]};
+            for (size_t bit{0}; bit < select_bits; bit++)
+                factors.push_back(((index >> bit) & 1) ? select[bit] : inverted[bit]);
+            terms.push_back(writer.gate("AND", factors));
+        }
+        writer.gate("OR", terms);
+        return writer;
+    }
+
+    /* Random circuit of layers of equal width, every gate reading signals of
+     * the previous layer; gates other than NOT and XOR take fanin inputs */
+    circuit_writer random_layers(size_t input_count, size_t gate_count, size_t fanin, uint64_t seed) {
+        const std::array<std::string, 4> names{"AND", "OR", "NAND", "NOR"};
+        std::mt19937_64 random{seed};
+        circuit_writer writer;
+        auto layer{make_inputs(writer, input_count)};
+
+        while (writer.gates < gate_count) {
+            sigvector next;
+            for (size_t i{0}; i < input_count && writer.gates < gate_count; i++) {
+                const auto kind{random() % (names.size() + 2)};
+                const auto arity{kind == names.size() ? 1 : kind == names.size() + 1 ? 2 : fanin};
+                sigvector operands(arity);
+                std::generate(begin(operands), end(operands), [&] { return layer[random() % layer.size()]; });
+                next.push_back(writer.gate(kind < names.size() ? names[kind] : arity == 1 ? "NOT" : "XOR",
+                                           operands));
+            }
+            layer = std::move(next);
+        }
+        return writer;
+    }
+
+    /* Seconds elapsed since a point in time */
+    double seconds_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /* Settings of the benchmark given on the command line */
+    struct bench_options {
+        size_t rows{1 << 15};
+        size_t fanin{3};
+        size_t gates{20000};
+    };
+
+    std::optional<bench_options> parse_bench_options(int argc, char* argv[]) {
+        bench_options settings;
+
+        for (int i{1}; i < argc; i++) {
+            const std::string option{argv[i]};
+            size_t* value{option == "--rows" ? &settings.rows : option == "--fanin" ? &settings.fanin
+                          : option == "--gates" ? &settings.gates : nullptr};
+
+            if (!value || i + 1 == argc) {
+                error::print_invalid_option_message(option);
+                return std::nullopt;
+            }
+
+            const std::string_view text{argv[++i]};
+            const auto [end, status]{std::from_chars(text.data(), text.data() + text.size(), *value)};
+            if (status != std::errc{} || end != text.data() + text.size() || *value == 0
+                || (value == &settings.fanin && *value < 2)) {
+                error::print_invalid_option_message(option + " " + std::string{text});
+                return std::nullopt;
+            }
+        }
+
+        return settings;
+    }
+
+    /* Times the phases of simulating a generated circuit for a number of rows,
+     * formatted output being discarded, and describes them as a JSON object.
+     * Nothing is returned if the generated netlist does not parse or the
+     * output cannot be written. */
+    std::optional<std::string> run_benchmark(const std::string& name, const std::string& parameters,
+                                             const circuit_writer& writer, size_t row_limit, output_writer& sink) {
+        using clock = std::chrono::steady_clock;
+
+        auto start{clock::now()};
+        gate_graph circuit;
+        if (!parse_netlist(writer.text, 1, circuit))
+            return std::nullopt;
+        const auto parse_time{seconds_since(start)};
+
+        start = clock::now();
+        const auto compiled{compile_circuit(circuit, std::nullopt)};
+        const auto levelize_time{seconds_since(start)};
+
+        const auto rows{std::min(row_limit, size_t{1} << std::min<size_t>(compiled.input_count, 63))};
+        const auto width{compiled.columns.size() + 1};
+        std::vector<logic::binblock> values(compiled.labels.size());
+        std::string buffer(block_lanes * width, '\0');
+        double evaluate_time{0};
+        double output_time{0};
+
+        for (size_t first{0}; first < rows; first += block_lanes) {
+            const auto count{std::min(block_lanes, rows - first)};
+
+            start = clock::now();
+            assign_inputs(compiled, values, first);
+            compute_gates(compiled, values);
+            evaluate_time += seconds_since(start);
+
+            start = clock::now();
+            format_block(compiled, values, count, buffer.data());
+            if (!sink.write({buffer.data(), count * width}))
+                return std::nullopt;
+            output_time += seconds_since(start);
+        }
+
+        const auto evaluated{static_cast<double>(compiled.gates.size()) * static_cast<double>(rows)};
+        return "    {\"circuit\": \"" + name + "\", \"parameters\": {" + parameters + "}"
+               + ", \"gates\": " + std::to_string(compiled.gates.size())
+               + ", \"inputs\": " + std::to_string(compiled.input_count)
+               + ", \"levels\": " + std::to_string(compiled.level_offsets.size() - 1)
+               + ", \"rows\": " + std::to_string(rows)
+               + ", \"netlist_bytes\": " + std::to_string(writer.text.size())
+               + ", \"parse_seconds\": " + std::to_string(parse_time)
+               + ", \"levelize_seconds\": " + std::to_string(levelize_time)
+               + ", \"evaluate_seconds\": " + std::to_string(evaluate_time)
+               + ", \"output_seconds\": " + std::to_string(output_time)
+               + ", \"gate_evaluations_per_second\": " + std::to_string(evaluated / std::max(evaluate_time, 1e-9))
+               + ", \"rows_per_second\": "
+               + std::to_string(static_cast<double>(rows) / std::max(evaluate_time + output_time, 1e-9)) + "}";
+    }
+}
+
+/* Benchmark of the simulator phases on generated circuits. Results are
+ * written to the standard output as a JSON document. */
+int main(int argc, char* argv[]) {
+    const auto settings{parse_bench_options(argc, argv)};
+    if (!settings)
+        return EXIT_FAILURE;
+
+    output_writer sink{"/dev/null"};
+    if (!sink.is_open()) {
+        error::print_output_file_message("/dev/null");
+        return EXIT_FAILURE;
+    }
+
+    const auto fanin{std::to_string(settings->fanin)};
+    const auto gates{std::to_string(settings->gates)};
+    const std::vector<std::tuple<std::string, std::string, circuit_writer>> circuits{
+            {"ripple_adder", "\"bits\": 16", ripple_adder(16)},
+            {"lookahead_adder", "\"bits\": 16", lookahead_adder(16)},
+            {"array_multiplier", "\"bits\": 12", array_multiplier(12)},
+            {"parity_tree", "\"inputs\": 32", parity_tree(32)},
+            {"multiplexer", "\"select_bits\": 5", multiplexer(5)},
+            {"random_layers", "\"inputs\": 32, \"gates\": " + gates + ", \"fanin\": " + fanin,
+             random_layers(32, settings->gates, settings->fanin, 1)},
+    };
+
+    std::string report{"{\n  \"kernels\": \""};
+    report += logic::simd::kernels().name;
+    report += "\",\n  \"results\": [\n";
+    for (size_t i{0}; i < circuits.size(); i++) {
+        const auto& [name, parameters, writer]{circuits[i]};
+        const auto result{run_benchmark(name, parameters, writer, settings->rows, sink)};
+        if (!result)
+            return EXIT_FAILURE;
+        report += *result;
+        report += i + 1 < circuits.size() ? ",\n" : "\n";
+    }
+    report += "  ]\n}\n";
+
+    return output_writer{}.write(report) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
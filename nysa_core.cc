@@ -0,0 +1,4210 @@
+#include "nysa.h"
+
+#include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <numeric>
+#include <cstdint>
+#include <array>
+#include <bit>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string_view>
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <atomic>
+#include <ctime>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <deque>
+#include <map>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <dlfcn.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <csignal>
+#include <linux/perf_event.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace logic {
+    /* Reduction applied over the inputs of an operation */
+    enum class fold { conj, disj, parity };
+
+    template<fold F, typename T>
+    T combine(const T& lhs, const T& rhs) {
+        if constexpr (F == fold::conj)
+            return lhs & rhs;
+        else if constexpr (F == fold::disj)
+            return lhs | rhs;
+        else
+            return lhs ^ rhs;
+    }
+
+    /* Logical operations, described by the reduction of their inputs
+     * and whether the result of the reduction is negated */
+    struct lnot {
+        static constexpr opcode code{opcode::lnot};
+        static constexpr fold reduction{fold::conj};
+        static constexpr bool inverted{true};
+
+        static const std::string name() {
+            return "NOT";
+        }
+    };
+
+    struct lxor {
+        static constexpr opcode code{opcode::lxor};
+        static constexpr fold reduction{fold::parity};
+        static constexpr bool inverted{false};
+
+        static const std::string name() {
+            return "XOR";
+        }
+    };
+
+    struct land {
+        static constexpr opcode code{opcode::land};
+        static constexpr fold reduction{fold::conj};
+        static constexpr bool inverted{false};
+
+        static const std::string name() {
+            return "AND";
+        }
+    };
+
+    struct lor {
+        static constexpr opcode code{opcode::lor};
+        static constexpr fold reduction{fold::disj};
+        static constexpr bool inverted{false};
+
+        static const std::string name() {
+            return "OR";
+        }
+    };
+
+    struct lnand {
+        static constexpr opcode code{opcode::lnand};
+        static constexpr fold reduction{fold::conj};
+        static constexpr bool inverted{true};
+
+        static const std::string name() {
+            return "NAND";
+        }
+    };
+
+    struct lnor {
+        static constexpr opcode code{opcode::lnor};
+        static constexpr fold reduction{fold::disj};
+        static constexpr bool inverted{true};
+
+        static const std::string name() {
+            return "NOR";
+        }
+    };
+
+    /* Calls a generic function with the operation of an opcode, so that
+     * the function is instantiated once per operation */
+    template<typename Function>
+    decltype(auto) visit(opcode op, Function&& function) {
+        switch (op) {
+            case opcode::lnot:
+                return function(lnot{});
+            case opcode::lxor:
+                return function(lxor{});
+            case opcode::land:
+                return function(land{});
+            case opcode::lor:
+                return function(lor{});
+            case opcode::lnand:
+                return function(lnand{});
+            default:
+                return function(lnor{});
+        }
+    }
+
+    /* Factory function for binding name to opcode */
+    opcode opcode_of(const std::string& name) {
+        if (name == lnot::name())
+            return opcode::lnot;
+        else if (name == lxor::name())
+            return opcode::lxor;
+        else if (name == land::name())
+            return opcode::land;
+        else if (name == lor::name())
+            return opcode::lor;
+        else if (name == lnand::name())
+            return opcode::lnand;
+        else if (name == lnor::name())
+            return opcode::lnor;
+        throw std::runtime_error("Operator " + name + " does not exist.");
+    }
+
+    /* Reduces the inputs of a gate with a single operation. Gates of up to
+     * three inputs, by far the most common, take unrolled paths. */
+    template<typename Operation, typename Value, typename Load>
+    Value reduce_inputs(const slot_t* inputs, size_t count, const Load& load) {
+        constexpr auto F{Operation::reduction};
+        auto result{load(inputs[0])};
+
+        switch (count) {
+            case 1:
+                break;
+            case 2:
+                result = combine<F, Value>(result, load(inputs[1]));
+                break;
+            case 3:
+                result = combine<F, Value>(combine<F, Value>(result, load(inputs[1])), load(inputs[2]));
+                break;
+            default:
+                for (size_t i{1}; i < count; i++)
+                    result = combine<F, Value>(result, load(inputs[i]));
+                break;
+        }
+
+        return result;
+    }
+
+    namespace simd {
+        /* Values of blocks held in general purpose registers */
+        struct scalar_block {
+            binblock words;
+
+            static scalar_block load(const binblock& block) {
+                return {block};
+            }
+
+            void store(binblock& block) const {
+                block = words;
+            }
+
+            scalar_block operator&(const scalar_block& other) const {
+                return apply(other, [](binword lhs, binword rhs) { return lhs & rhs; });
+            }
+
+            scalar_block operator|(const scalar_block& other) const {
+                return apply(other, [](binword lhs, binword rhs) { return lhs | rhs; });
+            }
+
+            scalar_block operator^(const scalar_block& other) const {
+                return apply(other, [](binword lhs, binword rhs) { return lhs ^ rhs; });
+            }
+
+            scalar_block operator~() const {
+                return apply(*this, [](binword value, binword) { return ~value; });
+            }
+
+        private:
+            template<typename Function>
+            scalar_block apply(const scalar_block& other, const Function& function) const {
+                scalar_block result;
+                for (size_t word{0}; word < block_words; word++)
+                    result.words[word] = function(words[word], other.words[word]);
+                return result;
+            }
+        };
+
+        /* Evaluates gates with blocks of a given representation; instantiated
+         * inside functions of the matching instruction set, which inline it
+         * together with the operations of every opcode */
+        template<typename Block>
+        void evaluate_gates(binblock* slots, const gate_record* gates, size_t count, const slot_t* fanins) {
+            for (size_t i{0}; i < count; i++) {
+                const auto& gate{gates[i]};
+                visit(gate.op, [&](auto operation) {
+                    using Operation = decltype(operation);
+                    auto result{reduce_inputs<Operation, Block>(
+                            fanins + gate.fanin_offset, gate.fanin_count,
+                            [&](slot_t input) { return Block::load(slots[input]); })};
+                    if constexpr (Operation::inverted)
+                        result = ~result;
+                    result.store(slots[gate.output]);
+                });
+            }
+        }
+
+        void scalar_gates(binblock* slots, const gate_record* gates, size_t count, const slot_t* fanins) {
+            evaluate_gates<scalar_block>(slots, gates, count, fanins);
+        }
+
+        /* Word with all digits set if the literal is complemented */
+        binword literal_mask(uint32_t literal) {
+            return binword{0} - (literal & 1);
+        }
+
+        void scalar_and_kernel(binblock* slots, const uint32_t* nodes, size_t count, slot_t first) {
+            for (size_t node{0}; node < count; node++) {
+                const auto lhs{nodes[2 * node]};
+                const auto rhs{nodes[2 * node + 1]};
+                const auto lhs_mask{literal_mask(lhs)};
+                const auto rhs_mask{literal_mask(rhs)};
+                const auto& lhs_block{slots[lhs >> 1]};
+                const auto& rhs_block{slots[rhs >> 1]};
+                auto& result{slots[first + node]};
+
+                for (size_t word{0}; word < block_words; word++)
+                    result[word] = (lhs_block[word] ^ lhs_mask) & (rhs_block[word] ^ rhs_mask);
+            }
+        }
+
+#if defined(__x86_64__) || defined(__i386__)
+        /* Values of blocks held in two AVX2 registers */
+        struct avx2_block {
+            __m256i low;
+            __m256i high;
+
+            [[gnu::target("avx2")]]
+            static avx2_block load(const binblock& block) {
+                return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block.data())),
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block.data() + 4))};
+            }
+
+            [[gnu::target("avx2")]]
+            void store(binblock& block) const {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(block.data()), low);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(block.data() + 4), high);
+            }
+
+            [[gnu::target("avx2")]]
+            avx2_block operator&(const avx2_block& other) const {
+                return {_mm256_and_si256(low, other.low), _mm256_and_si256(high, other.high)};
+            }
+
+            [[gnu::target("avx2")]]
+            avx2_block operator|(const avx2_block& other) const {
+                return {_mm256_or_si256(low, other.low), _mm256_or_si256(high, other.high)};
+            }
+
+            [[gnu::target("avx2")]]
+            avx2_block operator^(const avx2_block& other) const {
+                return {_mm256_xor_si256(low, other.low), _mm256_xor_si256(high, other.high)};
+            }
+
+            [[gnu::target("avx2")]]
+            avx2_block operator~() const {
+                const auto ones{_mm256_set1_epi64x(-1)};
+                return {_mm256_xor_si256(low, ones), _mm256_xor_si256(high, ones)};
+            }
+        };
+
+        /* Values of blocks held in a single AVX-512 register */
+        struct avx512_block {
+            __m512i value;
+
+            [[gnu::target("avx512f")]]
+            static avx512_block load(const binblock& block) {
+                static_assert(sizeof(binblock) == sizeof(__m512i));
+                return {_mm512_loadu_si512(block.data())};
+            }
+
+            [[gnu::target("avx512f")]]
+            void store(binblock& block) const {
+                _mm512_storeu_si512(block.data(), value);
+            }
+
+            [[gnu::target("avx512f")]]
+            avx512_block operator&(const avx512_block& other) const {
+                return {_mm512_and_si512(value, other.value)};
+            }
+
+            [[gnu::target("avx512f")]]
+            avx512_block operator|(const avx512_block& other) const {
+                return {_mm512_or_si512(value, other.value)};
+            }
+
+            [[gnu::target("avx512f")]]
+            avx512_block operator^(const avx512_block& other) const {
+                return {_mm512_xor_si512(value, other.value)};
+            }
+
+            [[gnu::target("avx512f")]]
+            avx512_block operator~() const {
+                return {_mm512_xor_si512(value, _mm512_set1_epi64(-1))};
+            }
+        };
+
+        [[gnu::target("avx2"), gnu::flatten]]
+        void avx2_gates(binblock* slots, const gate_record* gates, size_t count, const slot_t* fanins) {
+            evaluate_gates<avx2_block>(slots, gates, count, fanins);
+        }
+
+        [[gnu::target("avx512f"), gnu::flatten]]
+        void avx512_gates(binblock* slots, const gate_record* gates, size_t count, const slot_t* fanins) {
+            evaluate_gates<avx512_block>(slots, gates, count, fanins);
+        }
+
+        [[gnu::target("avx2")]]
+        void avx2_and_kernel(binblock* slots, const uint32_t* nodes, size_t count, slot_t first) {
+            constexpr size_t step{sizeof(__m256i) / sizeof(binword)};
+
+            for (size_t node{0}; node < count; node++) {
+                const auto lhs{nodes[2 * node]};
+                const auto rhs{nodes[2 * node + 1]};
+                const auto lhs_mask{_mm256_set1_epi64x(static_cast<int64_t>(literal_mask(lhs)))};
+                const auto rhs_mask{_mm256_set1_epi64x(static_cast<int64_t>(literal_mask(rhs)))};
+
+                for (size_t word{0}; word < block_words; word += step) {
+                    const auto lhs_value{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&slots[lhs >> 1][word]))};
+                    const auto rhs_value{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&slots[rhs >> 1][word]))};
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(&slots[first + node][word]),
+                                        _mm256_and_si256(_mm256_xor_si256(lhs_value, lhs_mask),
+                                                         _mm256_xor_si256(rhs_value, rhs_mask)));
+                }
+            }
+        }
+
+        [[gnu::target("avx512f")]]
+        void avx512_and_kernel(binblock* slots, const uint32_t* nodes, size_t count, slot_t first) {
+            for (size_t node{0}; node < count; node++) {
+                const auto lhs{nodes[2 * node]};
+                const auto rhs{nodes[2 * node + 1]};
+                const auto lhs_value{_mm512_xor_si512(_mm512_loadu_si512(slots[lhs >> 1].data()),
+                                                      _mm512_set1_epi64(static_cast<int64_t>(literal_mask(lhs))))};
+                const auto rhs_value{_mm512_xor_si512(_mm512_loadu_si512(slots[rhs >> 1].data()),
+                                                      _mm512_set1_epi64(static_cast<int64_t>(literal_mask(rhs))))};
+                _mm512_storeu_si512(slots[first + node].data(), _mm512_and_si512(lhs_value, rhs_value));
+            }
+        }
+#endif
+
+        const kernel_table& kernels() {
+            static const kernel_table table{[] {
+#if defined(__x86_64__) || defined(__i386__)
+                if (__builtin_cpu_supports("avx512f"))
+                    return kernel_table{"avx512", avx512_gates, avx512_and_kernel};
+                if (__builtin_cpu_supports("avx2"))
+                    return kernel_table{"avx2", avx2_gates, avx2_and_kernel};
+#endif
+                return kernel_table{"scalar", scalar_gates, scalar_and_kernel};
+            }()};
+
+            return table;
+        }
+    }
+
+    /* Evaluates an operation on single-digit values of the listed input slots */
+    bool evaluate(opcode op, const uint8_t* values, const slot_t* inputs, size_t count) {
+        return visit(op, [&](auto operation) {
+            using Operation = decltype(operation);
+            const auto result{reduce_inputs<Operation, uint8_t>(inputs, count, [&](slot_t input) {
+                return values[input];
+            })};
+            return (result != 0) != Operation::inverted;
+        });
+    }
+
+    std::vector<std::string> unary_names() {
+        return {lnot::name()};
+    }
+
+    std::vector<std::string> binary_names() {
+        return {lxor::name()};
+    }
+
+    std::vector<std::string> multi_names() {
+        return {land::name(), lnand::name(), lor::name(), lnor::name()};
+    }
+}
+
+namespace nysa {
+
+    sig_t gate_graph::index_of(sig_t label) {
+        const auto [entry, inserted]{indexes.try_emplace(label, static_cast<sig_t>(labels.size()))};
+        if (inserted) {
+            labels.push_back(label);
+            gates.emplace_back();
+        }
+        return entry->second;
+    }
+
+    void gate_graph::add_gate(sig_t signal, logic::opcode op, std::span<const sig_t> inputs) {
+        gates[signal] = {op, static_cast<uint32_t>(fanins.size()), static_cast<uint32_t>(inputs.size())};
+        fanins.insert(end(fanins), begin(inputs), end(inputs));
+    }
+
+    size_t gate_graph::size() const {
+        return gates.size();
+    }
+
+    bool gate_graph::contains(sig_t signal) const {
+        return gates[signal].fanin_count != 0;
+    }
+
+    gate_input gate_graph::at(sig_t signal) const {
+        const auto& gate{gates[signal]};
+        return {gate.op, {fanins.data() + gate.fanin_offset, gate.fanin_count}};
+    }
+
+    namespace error {
+        void print_invalid_parsing_message(uint64_t line, std::string_view info) {
+            std::cerr << "Error in line " << line << ": " << info << std::endl;
+        }
+
+        void print_repetitive_output_message(uint16_t line, sig_t signal) {
+            std::cerr << "Error in line " << line << ": " << "signal " << signal
+                      << " is assigned to multiple outputs." << std::endl;
+        }
+
+        void print_circuit_cycle_message() {
+            std::cerr << "Error: sequential logic analysis "
+                      << "has not yet been implemented." << std::endl;
+        }
+
+        void print_invalid_option_message(const std::string& option) {
+            std::cerr << "Error: invalid option " << option << "." << std::endl;
+        }
+
+        void print_output_file_message(const std::string& path) {
+            std::cerr << "Error: cannot open output file " << path << "." << std::endl;
+        }
+
+        void print_netlist_file_message(const std::string& path) {
+            std::cerr << "Error: cannot read netlist file " << path << "." << std::endl;
+        }
+
+        void print_unknown_signal_message(sig_t signal) {
+            std::cerr << "Error: signal " << signal << " does not exist in the circuit." << std::endl;
+        }
+
+        void print_vectors_file_message(const std::string& path) {
+            std::cerr << "Error: cannot read vectors file " << path << "." << std::endl;
+        }
+
+        void print_invalid_vector_message(uint64_t vector, size_t input_count, uint64_t written_count) {
+            std::cerr << "Error in vector " << vector << ": expected values of "
+                      << input_count << " inputs." << std::endl;
+            if (written_count != 0)
+                std::cerr << "Outputs of the first " << written_count
+                          << " vectors were already written." << std::endl;
+        }
+
+        void print_invalid_netlist_message(const std::string& path) {
+            std::cerr << "Error: netlist " << path << " is invalid." << std::endl;
+        }
+
+        void print_different_outputs_message() {
+            std::cerr << "Error: the netlists have different primary outputs." << std::endl;
+        }
+
+        void print_input_mismatch_message(sig_t signal) {
+            std::cerr << "Error: signal " << signal << " is an input of only one netlist." << std::endl;
+        }
+
+        void print_native_code_message() {
+            std::cerr << "Error: cannot compile the circuit to native code." << std::endl;
+        }
+
+        void print_output_write_message() {
+            std::cerr << "Error: writing the output failed." << std::endl;
+        }
+
+        void print_checkpoint_file_message(const std::string& path) {
+            std::cerr << "Error: cannot read checkpoint file " << path << "." << std::endl;
+        }
+
+        void print_checkpoint_mismatch_message(const std::string& path) {
+            std::cerr << "Error: checkpoint " << path << " does not match this run." << std::endl;
+        }
+
+        void print_checkpoint_write_message(const std::string& path) {
+            std::cerr << "Error: cannot write checkpoint file " << path << "." << std::endl;
+        }
+
+        void print_range_message(uint64_t first, uint64_t last, uint64_t combinations) {
+            std::cerr << "Error: range " << first << ":" << last << " exceeds the " << combinations
+                      << " combinations of the circuit." << std::endl;
+        }
+
+        void print_range_file_message(const std::string& path, const std::string& problem) {
+            std::cerr << "Error: range output " << path << " " << problem << "." << std::endl;
+        }
+
+        void print_missing_range_message(uint64_t last, uint64_t combinations) {
+            std::cerr << "Error: the ranges end at " << last << " of " << combinations
+                      << " combinations." << std::endl;
+        }
+
+        void print_worker_message() {
+            std::cerr << "Error: a worker process stopped unexpectedly." << std::endl;
+        }
+
+        void print_stats_disabled_message() {
+            std::cerr << "Error: statistics were disabled at build time." << std::endl;
+        }
+
+        void print_input_count_message(size_t input_count) {
+            std::cerr << "Error: the combinations of " << input_count
+                      << " inputs cannot be enumerated." << std::endl;
+        }
+    }
+
+    run_statistics& statistics() {
+        static run_statistics instance;
+        return instance;
+    }
+
+    uint64_t clock_nanoseconds(clockid_t clock) {
+        timespec time{};
+        ::clock_gettime(clock, &time);
+        return static_cast<uint64_t>(time.tv_sec) * 1000000000 + static_cast<uint64_t>(time.tv_nsec);
+    }
+
+#if NYSA_STATS
+    scoped_timer::scoped_timer(phase measured) : measured{measured}, active{statistics().enabled} {
+        if (active) {
+            wall = clock_nanoseconds(CLOCK_MONOTONIC);
+            cpu = clock_nanoseconds(CLOCK_THREAD_CPUTIME_ID);
+        }
+    }
+
+    scoped_timer::~scoped_timer() {
+        if (!active)
+            return;
+        auto& stats{statistics()};
+        const auto index{static_cast<size_t>(measured)};
+        stats.cpu_nanoseconds[index].fetch_add(clock_nanoseconds(CLOCK_THREAD_CPUTIME_ID) - cpu,
+                                               std::memory_order_relaxed);
+        stats.wall_nanoseconds[index].fetch_add(clock_nanoseconds(CLOCK_MONOTONIC) - wall,
+                                                std::memory_order_relaxed);
+    }
+#else
+    scoped_timer::scoped_timer(phase) {}
+#endif
+
+    /* Adds to a counter of the run. Counters are updated once per chunk,
+     * so they are kept whether or not times are recorded. */
+    void count_statistic(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    /* Event counting cache misses of a kind of read accesses */
+    constexpr counted_event read_miss_event(uint64_t cache) {
+        return {PERF_TYPE_HW_CACHE,
+                cache | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16};
+    }
+
+    /* Names of the events counted by --perf-counters */
+    constexpr std::array<const char*, 6> perf_event_names{
+            "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses", "dTLB-misses"};
+
+    const std::vector<counted_event>& perf_events() {
+        static const std::vector<counted_event> events{
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+                read_miss_event(PERF_COUNT_HW_CACHE_L1D),
+                read_miss_event(PERF_COUNT_HW_CACHE_LL),
+                read_miss_event(PERF_COUNT_HW_CACHE_DTLB)};
+        return events;
+    }
+
+    /* Events counted by --perf-counters while gates are evaluated, added
+     * up over the threads as each of them ends */
+    struct evaluation_counts {
+        bool enabled{false};
+        std::mutex mutex;
+        std::vector<std::optional<uint64_t>> totals;
+    };
+
+    evaluation_counts& counted_evaluations() {
+        static evaluation_counts instance;
+        return instance;
+    }
+
+    /* Counter group of a single thread, opened on its first evaluation
+     * and added to the totals when the thread ends */
+    class thread_counters {
+    public:
+        thread_counters() = default;
+        thread_counters(const thread_counters&) = delete;
+        thread_counters& operator=(const thread_counters&) = delete;
+
+        ~thread_counters() {
+            flush();
+        }
+
+        const counter_group& group() {
+            if (!counters)
+                counters.emplace(perf_events(), false, false);
+            return *counters;
+        }
+
+        /* Adds the counts of the thread so far to the totals */
+        void flush() {
+            if (!counters)
+                return;
+            const auto counts{counters->read()};
+            counters.reset();
+
+            auto& evaluations{counted_evaluations()};
+            const std::lock_guard lock{evaluations.mutex};
+            evaluations.totals.resize(counts.size());
+            for (size_t i{0}; i < counts.size(); i++)
+                if (counts[i])
+                    evaluations.totals[i] = evaluations.totals[i].value_or(0) + *counts[i];
+        }
+
+    private:
+        std::optional<counter_group> counters;
+    };
+
+    thread_counters& this_thread_counters() {
+        thread_local thread_counters instance;
+        return instance;
+    }
+
+    /* Counts the hardware events of the calling thread until the end of
+     * its scope, when --perf-counters is given */
+    class counted_section {
+    public:
+        counted_section() : active{counted_evaluations().enabled} {
+            if (active)
+                this_thread_counters().group().enable(true);
+        }
+
+        counted_section(const counted_section&) = delete;
+        counted_section& operator=(const counted_section&) = delete;
+
+        ~counted_section() {
+            if (active)
+                this_thread_counters().group().enable(false);
+        }
+
+    private:
+        bool active;
+    };
+
+    /* Gate described by a single input line */
+    struct gate_line {
+        logic::opcode op;
+        sig_t output;
+        sigvector inputs;
+    };
+
+    /* Name of a gate with the number of input signals it accepts */
+    struct gate_syntax {
+        std::string name;
+        logic::opcode op;
+        size_t min_inputs;
+        size_t max_inputs;
+    };
+
+    /* Syntax of all gates recognized in the input */
+    const std::vector<gate_syntax>& gate_syntaxes() {
+        static const auto syntaxes{[] {
+            std::vector<gate_syntax> result;
+            const auto add = [&](const std::vector<std::string>& names, size_t min, size_t max) {
+                for (const auto& name : names)
+                    result.push_back({name, logic::opcode_of(name), min, max});
+            };
+
+            add(logic::unary_names(), 1, 1);
+            add(logic::binary_names(), 2, 2);
+            add(logic::multi_names(), 2, SIZE_MAX);
+            return result;
+        }()};
+
+        return syntaxes;
+    }
+
+    /* Whitespace separating the tokens of a line */
+    bool is_blank(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+    }
+
+    /* Maximal number of digits in a signal identifier */
+    constexpr size_t signal_digits{9};
+
+    /* Validates an input line and extracts the gate it describes in a single
+     * pass. A line consists of a gate name followed by the output and input
+     * signals, all separated by whitespace; signals are positive numbers of at
+     * most nine digits. Assumption: gate.inputs may be reused between calls. */
+    bool parse_gate_line(std::string_view input, gate_line& gate) {
+        const auto* pos{input.data()};
+        const auto* const last{pos + input.size()};
+
+        while (pos != last && is_blank(*pos))
+            pos++;
+
+        const auto* const name_start{pos};
+        while (pos != last && !is_blank(*pos))
+            pos++;
+
+        const std::string_view name{name_start, static_cast<size_t>(pos - name_start)};
+        const auto& syntaxes{gate_syntaxes()};
+        const auto syntax{std::find_if(begin(syntaxes), end(syntaxes), [&](const gate_syntax& entry) {
+            return entry.name == name;
+        })};
+        if (syntax == std::end(syntaxes))
+            return false;
+
+        size_t signal_count{0};
+        gate.inputs.clear();
+
+        while (pos != last) {
+            /* Every signal is preceded by whitespace */
+            while (pos != last && is_blank(*pos))
+                pos++;
+            if (pos == last)
+                break;
+
+            if (*pos < '1' || *pos > '9')
+                return false;
+
+            sig_t signal{0};
+            const auto* const signal_start{pos};
+            while (pos != last && *pos >= '0' && *pos <= '9' && static_cast<size_t>(pos - signal_start) < signal_digits)
+                signal = signal * 10 + (*pos++ - '0');
+
+            if (pos != last && !is_blank(*pos))
+                return false;
+
+            if (signal_count++ == 0)
+                gate.output = signal;
+            else
+                gate.inputs.push_back(signal);
+        }
+
+        gate.op = syntax->op;
+        return signal_count > syntax->min_inputs && signal_count - 1 <= syntax->max_inputs;
+    }
+
+    /* Gate parsed from a line, its input signals kept in a separate buffer */
+    struct parsed_gate {
+        uint64_t line;
+        sig_t output;
+        logic::opcode op;
+        uint32_t input_count;
+    };
+
+    /* Gates and invalid lines parsed from a contiguous range of lines, stored
+     * in an arena of the chunk that is released in one piece after merging */
+    struct parsed_chunk {
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::vector<parsed_gate> gates{&arena};
+        std::pmr::vector<sig_t> inputs{&arena};
+        std::pmr::vector<std::pair<uint64_t, std::string_view>> invalid_lines{&arena};
+        uint64_t line_count{0};
+    };
+
+    /* Parses the lines of a text range; line numbers are relative to the range */
+    void parse_chunk(std::string_view text, parsed_chunk& chunk) {
+        const scoped_timer timer{phase::parse};
+        gate_line gate;
+
+        while (!text.empty()) {
+            const auto line_end{std::min(text.find('\n'), text.size())};
+            const auto line{text.substr(0, line_end)};
+            text.remove_prefix(std::min(line_end + 1, text.size()));
+
+            if (parse_gate_line(line, gate)) {
+                chunk.gates.push_back({chunk.line_count, gate.output, gate.op,
+                                       static_cast<uint32_t>(gate.inputs.size())});
+                chunk.inputs.insert(end(chunk.inputs), begin(gate.inputs), end(gate.inputs));
+            } else {
+                chunk.invalid_lines.emplace_back(chunk.line_count, line);
+            }
+            chunk.line_count++;
+        }
+    }
+
+    /* Smallest range of text worth parsing on a separate thread */
+    constexpr size_t min_parse_chunk{1 << 20};
+
+    bool parse_netlist(std::string_view text, size_t thread_count, gate_graph& circuit) {
+        const auto chunk_count{std::max<size_t>(1, std::min(thread_count, text.size() / min_parse_chunk))};
+
+        /* Chunks start right after the first line break following an even split */
+        std::vector<size_t> bounds{0};
+        for (size_t i{1}; i < chunk_count; i++) {
+            const auto split{text.find('\n', std::max(bounds.back(), i * text.size() / chunk_count))};
+            bounds.push_back(split == std::string_view::npos ? text.size() : split + 1);
+        }
+        bounds.push_back(text.size());
+
+        std::vector<parsed_chunk> chunks(chunk_count);
+        std::vector<std::thread> workers;
+        for (size_t i{1}; i < chunk_count; i++)
+            workers.emplace_back(parse_chunk, text.substr(bounds[i], bounds[i + 1] - bounds[i]),
+                                 std::ref(chunks[i]));
+        parse_chunk(text.substr(0, bounds[1]), chunks[0]);
+
+        std::for_each(begin(workers), end(workers), [](std::thread& worker) {
+            worker.join();
+        });
+
+        const scoped_timer timer{phase::parse};
+        size_t gate_count{0};
+        size_t input_count{0};
+        for (const auto& chunk : chunks) {
+            gate_count += chunk.gates.size();
+            input_count += chunk.inputs.size();
+        }
+        circuit.gates.reserve(gate_count);
+        circuit.labels.reserve(gate_count);
+        circuit.fanins.reserve(input_count);
+        circuit.indexes.reserve(gate_count);
+
+        bool error_occurred{false};
+        uint64_t first_line{1};
+
+        for (const auto& chunk : chunks) {
+            auto input{begin(chunk.inputs)};
+            auto invalid{begin(chunk.invalid_lines)};
+
+            const auto report_invalid_lines = [&](uint64_t until) {
+                for (; invalid != end(chunk.invalid_lines) && invalid->first < until; invalid++) {
+                    error::print_invalid_parsing_message(first_line + invalid->first, invalid->second);
+                    error_occurred = true;
+                }
+            };
+
+            for (const auto& gate : chunk.gates) {
+                report_invalid_lines(gate.line);
+
+                const auto signal{circuit.index_of(gate.output)};
+                const auto input_end{std::next(input, gate.input_count)};
+
+                if (!circuit.contains(signal)) {
+                    const auto offset{static_cast<uint32_t>(circuit.fanins.size())};
+                    std::for_each(input, input_end, [&](sig_t label) {
+                        circuit.fanins.push_back(circuit.index_of(label));
+                    });
+                    circuit.gates[signal] = {gate.op, offset, gate.input_count};
+                } else {
+                    error::print_repetitive_output_message(first_line + gate.line, gate.output);
+                    error_occurred = true;
+                }
+                input = input_end;
+            }
+
+            report_invalid_lines(chunk.line_count);
+            first_line += chunk.line_count;
+        }
+
+        return !error_occurred;
+    }
+
+    mapped_file::mapped_file(const std::string& path) {
+        const auto descriptor{::open(path.c_str(), O_RDONLY)};
+        if (descriptor < 0)
+            return;
+
+        struct stat status{};
+        if (::fstat(descriptor, &status) == 0) {
+            size = static_cast<size_t>(status.st_size);
+            if (size == 0) {
+                valid = true;
+            } else {
+                data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                valid = data != MAP_FAILED;
+                if (valid)
+                    ::madvise(data, size, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(descriptor);
+    }
+
+    mapped_file::~mapped_file() {
+        if (valid && size != 0)
+            ::munmap(data, size);
+    }
+
+    bool mapped_file::is_open() const {
+        return valid;
+    }
+
+    std::string_view mapped_file::text() const {
+        return size == 0 ? std::string_view{} : std::string_view{static_cast<const char*>(data), size};
+    }
+
+    std::string read_all(int descriptor) {
+        constexpr size_t block_size{1 << 20};
+        std::string text;
+
+        for (;;) {
+            const auto size{text.size()};
+            text.resize(size + block_size);
+
+            const auto count{::read(descriptor, text.data() + size, block_size)};
+            if (count < 0 && errno == EINTR) {
+                text.resize(size);
+                continue;
+            }
+
+            text.resize(size + static_cast<size_t>(std::max<ssize_t>(count, 0)));
+            if (count <= 0)
+                return text;
+        }
+    }
+
+    /* Gates reading each signal, stored as consecutive ranges of one array */
+    struct fanout_lists {
+        std::vector<uint32_t> offsets;
+        sigvector gates;
+
+        std::pair<const sig_t*, const sig_t*> of(sig_t signal) const {
+            return {gates.data() + offsets[signal], gates.data() + offsets[signal + 1]};
+        }
+    };
+
+    /* Collects the gates reading each signal, once per occurrence as input */
+    fanout_lists get_fanouts(const gate_graph& circuit) {
+        fanout_lists fanouts;
+        fanouts.offsets.assign(circuit.size() + 1, 0);
+
+        for (sig_t signal{0}; signal < static_cast<sig_t>(circuit.size()); signal++) {
+            if (circuit.contains(signal))
+                for (const auto input : circuit.at(signal).second)
+                    fanouts.offsets[input + 1]++;
+        }
+
+        std::partial_sum(begin(fanouts.offsets), end(fanouts.offsets), begin(fanouts.offsets));
+        fanouts.gates.resize(fanouts.offsets.back());
+
+        auto next{fanouts.offsets};
+        for (sig_t signal{0}; signal < static_cast<sig_t>(circuit.size()); signal++) {
+            if (circuit.contains(signal))
+                for (const auto input : circuit.at(signal).second)
+                    fanouts.gates[next[input]++] = signal;
+        }
+
+        return fanouts;
+    }
+
+    /* Order in which signals must be computed, with the logic level of each
+     * signal: independent inputs come first at level 0, and every gate is one
+     * level above its deepest input */
+    struct evaluation_order {
+        sigvector order;
+        std::vector<uint32_t> levels;
+        size_t input_count;
+    };
+
+    /* Produces an order in which gates must be computed. Signals are released
+     * once all their inputs are computed, which visits the gates by ascending
+     * logic level in time linear in the size of the circuit. */
+    evaluation_order get_signal_evaluation_order(const gate_graph& circuit) {
+        const auto fanouts{get_fanouts(circuit)};
+        evaluation_order result;
+        auto& order{result.order};
+        auto& levels{result.levels};
+
+        std::vector<uint32_t> pending(circuit.size(), 0);
+        levels.assign(circuit.size(), 0);
+        order.reserve(circuit.size());
+
+        for (sig_t signal{0}; signal < static_cast<sig_t>(circuit.size()); signal++) {
+            if (circuit.contains(signal))
+                pending[signal] = static_cast<uint32_t>(circuit.at(signal).second.size());
+            else
+                order.push_back(signal);
+        }
+        result.input_count = order.size();
+
+        /* The order itself serves as the queue of released signals */
+        for (size_t next{0}; next < order.size(); next++) {
+            const auto signal{order[next]};
+            const auto [first, last]{fanouts.of(signal)};
+
+            std::for_each(first, last, [&](sig_t gate) {
+                levels[gate] = std::max(levels[gate], levels[signal] + 1);
+                if (--pending[gate] == 0)
+                    order.push_back(gate);
+            });
+        }
+
+        /* Gates never released depend on their own output */
+        if (order.size() != circuit.size()) {
+            error::print_circuit_cycle_message();
+            exit(EXIT_FAILURE);
+        }
+
+        return result;
+    }
+
+    /* Lane patterns of the lowest input signals: lane l holds bit i of ordinal l */
+    constexpr logic::binword lane_patterns[] = {
+            0xAAAAAAAAAAAAAAAA, 0xCCCCCCCCCCCCCCCC, 0xF0F0F0F0F0F0F0F0,
+            0xFF00FF00FF00FF00, 0xFFFF0000FFFF0000, 0xFFFFFFFF00000000
+    };
+
+    /* Number of input signals whose lane pattern is the same in every word */
+    constexpr size_t lane_bits{std::size(lane_patterns)};
+
+    /* Marks the signals in the transitive fan-in cones of the selected signals */
+    std::vector<bool> get_cone_of_influence(const gate_graph& circuit, const sigvector& selection) {
+        std::vector<bool> in_cone(circuit.size(), false);
+        sigvector pending;
+
+        const auto visit = [&](sig_t signal) {
+            if (!in_cone[signal]) {
+                in_cone[signal] = true;
+                pending.push_back(signal);
+            }
+        };
+
+        std::for_each(begin(selection), end(selection), visit);
+        while (!pending.empty()) {
+            const auto signal{pending.back()};
+            pending.pop_back();
+            if (circuit.contains(signal))
+                std::for_each(begin(circuit.at(signal).second), end(circuit.at(signal).second), visit);
+        }
+
+        return in_cone;
+    }
+
+    netlist compile_circuit(const gate_graph& circuit, const std::optional<sigvector>& selection,
+                            const sigvector& retained) {
+        auto [order, levels, input_count]{get_signal_evaluation_order(circuit)};
+        netlist compiled;
+
+        if (selection) {
+            auto in_cone{get_cone_of_influence(circuit, *selection)};
+            for (const auto signal : retained)
+                in_cone[signal] = true;
+            std::erase_if(order, [&](sig_t signal) {
+                return !in_cone[signal];
+            });
+            input_count = static_cast<size_t>(std::count_if(begin(order), end(order), [&](sig_t signal) {
+                return !circuit.contains(signal);
+            }));
+        }
+
+        compiled.input_count = input_count;
+
+        /* Sort independent inputs by ascending order */
+        auto input_end{std::next(begin(order), static_cast<int32_t>(compiled.input_count))};
+        std::sort(begin(order), input_end, [&](sig_t lhs, sig_t rhs) {
+            return circuit.labels[lhs] > circuit.labels[rhs];
+        });
+
+        std::vector<logic::slot_t> slots(circuit.size());
+        for (const auto signal : order) {
+            slots[signal] = static_cast<logic::slot_t>(compiled.labels.size());
+            compiled.labels.push_back(circuit.labels[signal]);
+        }
+
+        std::for_each(input_end, end(order), [&](sig_t signal) {
+            const auto& [op, inputs]{circuit.at(signal)};
+            while (compiled.level_offsets.size() < levels[signal])
+                compiled.level_offsets.push_back(static_cast<uint32_t>(compiled.gates.size()));
+            compiled.gates.push_back({op, static_cast<uint32_t>(compiled.fanins.size()),
+                                      static_cast<uint32_t>(inputs.size()), slots[signal]});
+            for (const auto input : inputs)
+                compiled.fanins.push_back(slots[input]);
+        });
+        compiled.level_offsets.push_back(static_cast<uint32_t>(compiled.gates.size()));
+
+        if (selection) {
+            std::transform(begin(*selection), end(*selection), std::back_inserter(compiled.columns),
+                           [&](sig_t signal) { return slots[signal]; });
+            std::transform(begin(*selection), end(*selection), std::back_inserter(compiled.column_labels),
+                           [&](sig_t signal) { return circuit.labels[signal]; });
+            return compiled;
+        }
+
+        /* Signals are displayed by ascending order */
+        compiled.columns.resize(order.size());
+        std::iota(begin(compiled.columns), end(compiled.columns), 0);
+        std::sort(begin(compiled.columns), end(compiled.columns), [&](auto lhs, auto rhs) {
+            return compiled.labels[lhs] < compiled.labels[rhs];
+        });
+        std::transform(begin(compiled.columns), end(compiled.columns), std::back_inserter(compiled.column_labels),
+                       [&](logic::slot_t slot) { return compiled.labels[slot]; });
+
+        return compiled;
+    }
+
+    /* Hash of a gate given as its opcode followed by its inputs */
+    struct gate_key_hash {
+        size_t operator()(const sigvector& key) const {
+            size_t hash{key.size()};
+            for (const auto signal : key)
+                hash = (hash ^ static_cast<uint32_t>(signal)) * 0x9E3779B97F4A7C15;
+            return hash;
+        }
+    };
+
+    /* Rebuilds a circuit gate by gate into a smaller equivalent one. Every
+     * signal of the original circuit is mapped to a literal: a signal of the
+     * reduced circuit or a constant. Identical gates over the same inputs are
+     * shared, constants are folded into the gates reading them, and negations
+     * of negations lead back to the original signal. */
+    class circuit_optimizer {
+    public:
+        /* Literals of the constant values */
+        static constexpr sig_t false_literal{-1};
+        static constexpr sig_t true_literal{-2};
+
+        explicit circuit_optimizer(const gate_graph& circuit)
+                : circuit{circuit}, literals(circuit.size(), false_literal) {}
+
+        sig_t literal_of(sig_t signal) const {
+            return literals[signal];
+        }
+
+        void add_input(sig_t signal) {
+            literals[signal] = reduced.index_of(circuit.labels[signal]);
+            complements.resize(reduced.size(), -1);
+        }
+
+        /* Maps a gate whose inputs are all mapped already */
+        void add_gate(sig_t signal) {
+            const auto& [op, inputs]{circuit.at(signal)};
+            const auto label{circuit.labels[signal]};
+            sigvector operands;
+            std::transform(begin(inputs), end(inputs), std::back_inserter(operands), [&](sig_t input) {
+                return literals[input];
+            });
+
+            switch (op) {
+                case logic::opcode::lnot:
+                    literals[signal] = negate(operands[0], label);
+                    return;
+                case logic::opcode::lxor:
+                    literals[signal] = add_parity(operands, label);
+                    return;
+                default:
+                    literals[signal] = add_conjunction(op, operands, label);
+                    return;
+            }
+        }
+
+        /* Signal of the reduced circuit holding a literal, creating
+         * a gate for a constant from any input signal */
+        sig_t materialize(sig_t literal, sig_t input) {
+            if (literal >= 0)
+                return literal;
+
+            const auto zero{make_gate(logic::opcode::lxor, {input, input}, false_literal)};
+            return literal == false_literal ? zero : make_gate(logic::opcode::lnot, {zero}, true_literal);
+        }
+
+        gate_graph reduced;
+
+    private:
+        static sig_t constant(bool value) {
+            return value ? true_literal : false_literal;
+        }
+
+        /* Creates a gate in the reduced circuit unless the same one exists */
+        sig_t make_gate(logic::opcode op, const sigvector& inputs, sig_t label) {
+            sigvector key{static_cast<sig_t>(op)};
+            key.insert(end(key), begin(inputs), end(inputs));
+
+            const auto [entry, inserted]{structures.try_emplace(std::move(key), 0)};
+            if (!inserted)
+                return entry->second;
+
+            const auto signal{reduced.index_of(label)};
+            reduced.add_gate(signal, op, inputs);
+            complements.resize(reduced.size(), -1);
+            if (op == logic::opcode::lnot)
+                complements[signal] = inputs[0];
+            entry->second = signal;
+            return signal;
+        }
+
+        sig_t negate(sig_t literal, sig_t label) {
+            if (literal < 0)
+                return constant(literal == false_literal);
+            if (complements[literal] >= 0)
+                return complements[literal];
+            return make_gate(logic::opcode::lnot, {literal}, label);
+        }
+
+        bool complementary(sig_t lhs, sig_t rhs) const {
+            return complements[lhs] == rhs || complements[rhs] == lhs;
+        }
+
+        sig_t add_parity(const sigvector& operands, sig_t label) {
+            sigvector rest;
+            bool inverted{false};
+            for (const auto operand : operands) {
+                if (operand == true_literal)
+                    inverted = !inverted;
+                else if (operand != false_literal)
+                    rest.push_back(operand);
+            }
+
+            if (rest.size() == 2 && (rest[0] == rest[1] || complementary(rest[0], rest[1]))) {
+                inverted = rest[0] != rest[1];
+                rest.clear();
+            }
+
+            if (rest.empty())
+                return constant(inverted);
+            if (rest.size() == 1)
+                return inverted ? negate(rest[0], label) : rest[0];
+
+            std::sort(begin(rest), end(rest));
+            return make_gate(logic::opcode::lxor, rest, label);
+        }
+
+        /* Conjunctions and disjunctions, possibly negated */
+        sig_t add_conjunction(logic::opcode op, const sigvector& operands, sig_t label) {
+            const auto conjunction{op == logic::opcode::land || op == logic::opcode::lnand};
+            const auto negated{op == logic::opcode::lnand || op == logic::opcode::lnor};
+
+            /* Value of any input deciding the result on its own */
+            const auto controlling{!conjunction};
+            sigvector rest;
+            bool decided{false};
+            for (const auto operand : operands) {
+                if (operand == constant(controlling))
+                    decided = true;
+                else if (operand != constant(!controlling))
+                    rest.push_back(operand);
+            }
+
+            std::sort(begin(rest), end(rest));
+            rest.erase(std::unique(begin(rest), end(rest)), end(rest));
+            decided |= std::any_of(begin(rest), end(rest), [&](sig_t operand) {
+                return complements[operand] >= 0 && std::binary_search(begin(rest), end(rest), complements[operand]);
+            });
+
+            if (decided)
+                return constant(controlling != negated);
+            if (rest.empty())
+                return constant(controlling == negated);
+            if (rest.size() == 1)
+                return negated ? negate(rest[0], label) : rest[0];
+            return make_gate(op, rest, label);
+        }
+
+        const gate_graph& circuit;
+        sigvector literals;
+        /* Input of every NOT gate of the reduced circuit, -1 for other signals */
+        sigvector complements;
+        std::unordered_map<sigvector, sig_t, gate_key_hash> structures;
+    };
+
+    /* Compiles the circuit after reducing the cones of the displayed signals:
+     * duplicate gates are shared, constants folded, double negations removed,
+     * and gates no displayed signal depends on are dropped. Displayed signals
+     * keep their columns, also when merged into others or constant. */
+    netlist optimize_circuit(const gate_graph& circuit, const std::optional<sigvector>& selection) {
+        const auto order{get_signal_evaluation_order(circuit).order};
+        const auto in_cone{selection ? get_cone_of_influence(circuit, *selection)
+                                     : std::vector<bool>(circuit.size(), true)};
+        circuit_optimizer optimizer{circuit};
+        sigvector inputs;
+
+        for (const auto signal : order) {
+            if (!in_cone[signal])
+                continue;
+            if (circuit.contains(signal)) {
+                optimizer.add_gate(signal);
+            } else {
+                optimizer.add_input(signal);
+                inputs.push_back(optimizer.literal_of(signal));
+            }
+        }
+
+        sigvector displayed;
+        if (selection) {
+            displayed = *selection;
+        } else {
+            displayed = order;
+            std::sort(begin(displayed), end(displayed), [&](sig_t lhs, sig_t rhs) {
+                return circuit.labels[lhs] < circuit.labels[rhs];
+            });
+        }
+
+        /* Inputs stay enumerated even if no displayed signal depends on them anymore */
+        sigvector columns;
+        for (const auto signal : displayed)
+            columns.push_back(optimizer.materialize(optimizer.literal_of(signal), inputs.front()));
+
+        auto compiled{compile_circuit(optimizer.reduced, columns, inputs)};
+        compiled.column_labels.clear();
+        std::transform(begin(displayed), end(displayed), std::back_inserter(compiled.column_labels),
+                       [&](sig_t signal) { return circuit.labels[signal]; });
+
+        const auto gate_count{std::count_if(begin(order), end(order), [&](sig_t signal) {
+            return circuit.contains(signal);
+        })};
+        std::cerr << "Optimization: " << gate_count << " gates before, "
+                  << compiled.gates.size() << " after." << std::endl;
+
+        return compiled;
+    }
+
+    void compute_gates(const netlist& compiled, std::vector<logic::binblock>& values) {
+        logic::simd::kernels().gates(values.data(), compiled.gates.data(), compiled.gates.size(),
+                                     compiled.fanins.data());
+        count_statistic(statistics().gate_evaluations, compiled.gates.size() * block_lanes);
+    }
+
+    /* Form of assign_inputs shared by every kind of compiled circuit */
+    template<typename Circuit>
+    void assign_inputs(const Circuit& compiled, std::vector<logic::binblock>& values, size_t input) {
+        /* Lanes of a word hold consecutive combinations: the low bits of
+         * the ordinal follow fixed patterns, the high bits are shared */
+        for (size_t bit{0}; bit < compiled.input_count; bit++) {
+            auto& value{values[bit]};
+            for (size_t word{0}; word < logic::block_words; word++) {
+                if (bit < lane_bits)
+                    value[word] = lane_patterns[bit];
+                else
+                    value[word] = (((input + word * word_lanes) >> bit) & 1) ? ~logic::binword{0} : 0;
+            }
+        }
+    }
+
+    void assign_inputs(const netlist& compiled, std::vector<logic::binblock>& values, size_t input) {
+        assign_inputs<netlist>(compiled, values, input);
+    }
+
+    /* Circuit lowered to two-input AND nodes over complemented-edge literals,
+     * literal 2s + c standing for slot s negated if c is set. Input signals
+     * occupy the leading slots as in the compiled circuit, followed by a slot
+     * of constant zero and by one slot per node, whose two literals are packed
+     * in consecutive entries of the node array. Complemented columns are
+     * copied negated to trailing slots, so every column is a plain slot. */
+    struct and_inverter_graph {
+        std::vector<uint32_t> nodes;
+        std::vector<std::pair<logic::slot_t, logic::slot_t>> negations;
+        std::vector<logic::slot_t> columns;
+        size_t input_count;
+
+        logic::slot_t first_node() const {
+            return static_cast<logic::slot_t>(input_count + 1);
+        }
+
+        size_t slot_count() const {
+            return input_count + 1 + nodes.size() / 2 + negations.size();
+        }
+    };
+
+    /* Builds the AND nodes of a graph, sharing nodes over the same literals
+     * and simplifying those with constant, equal or complementary literals */
+    class aig_builder {
+    public:
+        explicit aig_builder(and_inverter_graph& graph)
+                : graph{graph}, false_literal{static_cast<uint32_t>(2 * graph.input_count)} {}
+
+        uint32_t conjunction(uint32_t lhs, uint32_t rhs) {
+            if (lhs > rhs)
+                std::swap(lhs, rhs);
+            if (lhs == false_literal || rhs == false_literal || (lhs ^ 1) == rhs)
+                return false_literal;
+            if (lhs == (false_literal ^ 1) || lhs == rhs)
+                return rhs;
+            if (rhs == (false_literal ^ 1))
+                return lhs;
+
+            const auto [entry, inserted]{nodes.try_emplace(uint64_t{lhs} << 32 | rhs, 0)};
+            if (inserted) {
+                entry->second = 2 * (graph.first_node() + static_cast<uint32_t>(graph.nodes.size() / 2));
+                graph.nodes.push_back(lhs);
+                graph.nodes.push_back(rhs);
+            }
+            return entry->second;
+        }
+
+        /* Conjunction of many literals as a balanced tree of nodes */
+        uint32_t conjunction(std::vector<uint32_t> literals) {
+            while (literals.size() > 1) {
+                for (size_t i{0}; 2 * i < literals.size(); i++)
+                    literals[i] = 2 * i + 1 < literals.size()
+                                  ? conjunction(literals[2 * i], literals[2 * i + 1]) : literals[2 * i];
+                literals.resize((literals.size() + 1) / 2);
+            }
+            return literals[0];
+        }
+
+        uint32_t parity(uint32_t lhs, uint32_t rhs) {
+            return conjunction(conjunction(lhs, rhs) ^ 1, conjunction(lhs ^ 1, rhs ^ 1) ^ 1);
+        }
+
+    private:
+        and_inverter_graph& graph;
+        const uint32_t false_literal;
+        std::unordered_map<uint64_t, uint32_t> nodes;
+    };
+
+    /* Lowers a compiled circuit to an and-inverter graph with the same columns */
+    and_inverter_graph lower_to_aig(const netlist& compiled) {
+        const scoped_timer timer{phase::compile};
+        and_inverter_graph graph;
+        graph.input_count = compiled.input_count;
+        aig_builder builder{graph};
+
+        std::vector<uint32_t> literals(compiled.labels.size());
+        for (logic::slot_t slot{0}; slot < compiled.input_count; slot++)
+            literals[slot] = 2 * slot;
+
+        std::vector<uint32_t> inputs;
+        for (const auto& gate : compiled.gates) {
+            inputs.clear();
+            for (uint32_t i{0}; i < gate.fanin_count; i++)
+                inputs.push_back(literals[compiled.fanins[gate.fanin_offset + i]]);
+
+            /* Disjunctions are negated conjunctions of negated inputs */
+            const auto negate_inputs = [&] {
+                std::for_each(begin(inputs), end(inputs), [](uint32_t& literal) { literal ^= 1; });
+            };
+
+            auto& result{literals[gate.output]};
+            switch (gate.op) {
+                case logic::opcode::lnot:
+                    result = inputs[0] ^ 1;
+                    break;
+                case logic::opcode::lxor:
+                    result = std::accumulate(std::next(begin(inputs)), end(inputs), inputs[0],
+                                             [&](uint32_t lhs, uint32_t rhs) { return builder.parity(lhs, rhs); });
+                    break;
+                case logic::opcode::land:
+                    result = builder.conjunction(inputs);
+                    break;
+                case logic::opcode::lnand:
+                    result = builder.conjunction(inputs) ^ 1;
+                    break;
+                case logic::opcode::lor:
+                    negate_inputs();
+                    result = builder.conjunction(inputs) ^ 1;
+                    break;
+                case logic::opcode::lnor:
+                    negate_inputs();
+                    result = builder.conjunction(inputs);
+                    break;
+            }
+        }
+
+        const auto first_negation{graph.first_node() + graph.nodes.size() / 2};
+        for (const auto slot : compiled.columns) {
+            const auto literal{literals[slot]};
+            if (literal & 1) {
+                graph.columns.push_back(static_cast<logic::slot_t>(first_negation + graph.negations.size()));
+                graph.negations.emplace_back(graph.columns.back(), literal >> 1);
+            } else {
+                graph.columns.push_back(literal >> 1);
+            }
+        }
+
+        return graph;
+    }
+
+    /* Evaluates all nodes for a block of combinations of input signals */
+    void compute_gates(const and_inverter_graph& graph, std::vector<logic::binblock>& values) {
+        logic::simd::kernels().conjunctions(values.data(), graph.nodes.data(), graph.nodes.size() / 2,
+                                            graph.first_node());
+        for (const auto& [target, source] : graph.negations)
+            for (size_t word{0}; word < logic::block_words; word++)
+                values[target][word] = ~values[source][word];
+        count_statistic(statistics().gate_evaluations, graph.nodes.size() / 2 * block_lanes);
+    }
+
+    netlist prepare_circuit(const gate_graph& circuit, const std::optional<sigvector>& selection,
+                            const options& settings) {
+        const scoped_timer timer{phase::compile};
+        return settings.optimize ? optimize_circuit(circuit, selection) : compile_circuit(circuit, selection);
+    }
+
+    output_writer::output_writer() : descriptor{STDOUT_FILENO}, owned{false} {}
+
+    output_writer::output_writer(const std::string& path)
+            : descriptor{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)}, owned{true} {}
+
+    output_writer::output_writer(const std::string& path, uint64_t offset)
+            : descriptor{::open(path.c_str(), O_WRONLY)}, owned{true}, written{offset} {
+        struct stat status{};
+        if (descriptor >= 0 && (::fstat(descriptor, &status) != 0 || static_cast<uint64_t>(status.st_size) < offset
+                                || ::ftruncate(descriptor, static_cast<off_t>(offset)) != 0
+                                || ::lseek(descriptor, static_cast<off_t>(offset), SEEK_SET) < 0)) {
+            ::close(descriptor);
+            descriptor = -1;
+        }
+    }
+
+    output_writer::~output_writer() {
+        if (owned && descriptor >= 0)
+            ::close(descriptor);
+    }
+
+    bool output_writer::is_open() const {
+        return descriptor >= 0;
+    }
+
+    uint64_t output_writer::position() const {
+        return written;
+    }
+
+    bool output_writer::sync() const {
+        return ::fdatasync(descriptor) == 0;
+    }
+
+    bool output_writer::write(std::string_view data) {
+        const scoped_timer timer{phase::write};
+        count_statistic(statistics().bytes_written, data.size());
+        written += data.size();
+        while (!data.empty()) {
+            const auto count{::write(descriptor, data.data(), data.size())};
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count < 0) {
+                error::print_output_write_message();
+                return false;
+            }
+            data.remove_prefix(static_cast<size_t>(count));
+        }
+        return true;
+    }
+
+    /* Sixteen hexadecimal digits of a hash, leading zeros included */
+    std::string hash_digits(uint64_t hash) {
+        std::string digits(16, '0');
+        for (auto digit{rbegin(digits)}; hash != 0; hash >>= 4)
+            *digit++ = "0123456789abcdef"[hash & 15];
+        return digits;
+    }
+
+    uint64_t hash_bytes(std::string_view data, uint64_t hash) {
+        for (const auto c : data)
+            hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3;
+        return hash;
+    }
+
+    uint64_t run_hash(std::string_view text, const std::optional<sigvector>& selection) {
+        auto hash{hash_bytes(text)};
+        if (selection)
+            for (const auto signal : *selection)
+                hash = hash_bytes(" " + std::to_string(signal), hash);
+        return hash;
+    }
+
+    std::optional<checkpoint> read_checkpoint(const std::string& path) {
+        const auto descriptor{::open(path.c_str(), O_RDONLY)};
+        if (descriptor < 0)
+            return std::nullopt;
+        const auto text{read_all(descriptor)};
+        ::close(descriptor);
+
+        checkpoint state;
+        const std::array<std::pair<std::string_view, uint64_t*>, 3> fields{{
+                {"netlist ", &state.netlist_hash}, {"ordinal ", &state.next_ordinal},
+                {"offset ", &state.output_offset}}};
+        std::string_view rest{text};
+        for (const auto& [name, value] : fields) {
+            const auto line_end{rest.find('\n')};
+            if (line_end == std::string_view::npos || !rest.starts_with(name))
+                return std::nullopt;
+            const auto* const first{rest.data() + name.size()};
+            const auto* const last{rest.data() + line_end};
+            const auto [end, status]{std::from_chars(first, last, *value, value == &state.netlist_hash ? 16 : 10)};
+            if (status != std::errc{} || end != last)
+                return std::nullopt;
+            rest.remove_prefix(line_end + 1);
+        }
+        return rest.empty() ? std::optional{state} : std::nullopt;
+    }
+
+    /* Time between saves of the progress of an enumeration */
+    constexpr std::chrono::seconds checkpoint_interval{30};
+
+    checkpoint_writer::checkpoint_writer(std::string path, const checkpoint& state)
+            : path{std::move(path)}, state{state}, saved{std::chrono::steady_clock::now()} {}
+
+    const checkpoint& checkpoint_writer::progress() const {
+        return state;
+    }
+
+    bool checkpoint_writer::advance(uint64_t next_ordinal, const output_writer& output, bool finished) {
+        state.next_ordinal = next_ordinal;
+        state.output_offset = output.position();
+
+        const auto now{std::chrono::steady_clock::now()};
+        if (!finished && now - saved < checkpoint_interval)
+            return true;
+        saved = now;
+
+        /* Progress must never refer to output that may be lost */
+        if (!output.sync()) {
+            error::print_output_write_message();
+            return false;
+        }
+        const auto text{"netlist " + hash_digits(state.netlist_hash) + "\nordinal " + std::to_string(state.next_ordinal)
+                        + "\noffset " + std::to_string(state.output_offset) + "\n"};
+
+        const auto temporary{path + ".tmp"};
+        const auto descriptor{::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)};
+        const auto stored{descriptor >= 0 && ::write(descriptor, text.data(), text.size())
+                                             == static_cast<ssize_t>(text.size())
+                          && ::fdatasync(descriptor) == 0};
+        const auto closed{descriptor >= 0 && ::close(descriptor) == 0};
+
+        /* A run whose progress cannot be saved stops rather than going on
+         * with nothing to resume from */
+        if (!stored || !closed || ::rename(temporary.c_str(), path.c_str()) != 0) {
+            ::unlink(temporary.c_str());
+            error::print_checkpoint_write_message(path);
+            return false;
+        }
+
+        /* The renaming is stored with the directory holding the file */
+        const auto slash{path.rfind('/')};
+        const auto directory{slash == std::string::npos ? std::string{"."}
+                             : path.substr(0, std::max<size_t>(slash, 1))};
+        const auto directory_descriptor{::open(directory.c_str(), O_RDONLY | O_DIRECTORY)};
+        const auto synced{directory_descriptor >= 0 && ::fsync(directory_descriptor) == 0};
+        if (directory_descriptor >= 0)
+            ::close(directory_descriptor);
+        if (!synced)
+            error::print_checkpoint_write_message(path);
+        return synced;
+    }
+
+    /* Form of format_block shared by every kind of compiled circuit */
+    template<typename Circuit>
+    void format_block(const Circuit& compiled, const std::vector<logic::binblock>& values,
+                      size_t rows, char* buffer) {
+        const auto width{compiled.columns.size() + 1};
+
+        for (size_t word{0}; word * word_lanes < rows; word++) {
+            const auto lanes{std::min(word_lanes, rows - word * word_lanes)};
+            auto* const first_row{buffer + word * word_lanes * width};
+
+            for (size_t column{0}; column < compiled.columns.size(); column++) {
+                auto bits{values[compiled.columns[column]][word]};
+                auto* digit{first_row + column};
+                for (size_t lane{0}; lane < lanes; lane++, bits >>= 1, digit += width)
+                    *digit = static_cast<char>('0' | (bits & 1));
+            }
+
+            for (size_t lane{0}; lane < lanes; lane++)
+                first_row[lane * width + width - 1] = '\n';
+        }
+    }
+
+    void format_block(const netlist& compiled, const std::vector<logic::binblock>& values,
+                      size_t rows, char* buffer) {
+        format_block<netlist>(compiled, values, rows, buffer);
+    }
+
+    /* Formats output rows for the combinations in range [first, last).
+     * Blocks are aligned to their size; the rows of a block before the
+     * start of an unaligned range are formatted aside and dropped. */
+    template<typename Circuit>
+    void format_circuit_outputs(const Circuit& compiled, std::vector<logic::binblock>& values,
+                                size_t first, size_t last, std::string& buffer) {
+        const auto width{compiled.columns.size() + 1};
+        buffer.resize((last - first) * width);
+
+        for (size_t input{first}; input < last;) {
+            const auto block{input - input % block_lanes};
+            const auto rows{std::min(block + block_lanes, last) - block};
+
+            {
+                const scoped_timer timer{phase::evaluate};
+                const counted_section counting;
+                assign_inputs(compiled, values, block);
+                compute_gates(compiled, values);
+            }
+            const scoped_timer timer{phase::format};
+            if (block == input) {
+                format_block(compiled, values, rows, buffer.data() + (input - first) * width);
+            } else {
+                std::string rows_before(rows * width, '\0');
+                format_block(compiled, values, rows, rows_before.data());
+                std::copy(std::next(begin(rows_before), static_cast<ptrdiff_t>((input - block) * width)),
+                          end(rows_before), buffer.data());
+            }
+            input = block + rows;
+        }
+    }
+
+    /* Approximate size of the output formatted by a worker at a time */
+    constexpr size_t chunk_bytes{1 << 22};
+
+    /* Displays the combinations in range [first, last) formatted by a pool
+     * of workers, by ascending ordinal. Ranges given to the workers are the
+     * parts of aligned chunks within the displayed range. Every worker
+     * formats its ranges with a formatter of its own, which keeps the values
+     * of signals between ranges. Progress is recorded after every range
+     * displayed. Returns false once the output cannot be written, leaving
+     * the remaining chunks aside. */
+    template<typename FormatterFactory>
+    bool print_chunks(size_t first, size_t last, size_t chunk_lanes, size_t thread_count,
+                      output_writer& output, checkpoint_writer* progress,
+                      const FormatterFactory& make_formatter) {
+        const auto first_chunk{first / chunk_lanes};
+        const auto chunk_count{first < last ? (last + chunk_lanes - 1) / chunk_lanes - first_chunk : 0};
+
+        const auto chunk_start = [&](size_t chunk) {
+            return std::max(first, (first_chunk + chunk) * chunk_lanes);
+        };
+        const auto chunk_end = [&](size_t chunk) {
+            return std::min(last, (first_chunk + chunk + 1) * chunk_lanes);
+        };
+
+        const auto format_chunk = [&](size_t chunk, auto& formatter, std::string& buffer) {
+            formatter(chunk_start(chunk), chunk_end(chunk), buffer);
+            count_statistic(statistics().rows, chunk_end(chunk) - chunk_start(chunk));
+        };
+
+        const auto display_chunk = [&](size_t chunk, const std::string& buffer) {
+            return output.write(buffer)
+                   && (!progress || progress->advance(chunk_end(chunk), output, chunk + 1 == chunk_count));
+        };
+
+        if (thread_count <= 1 || chunk_count <= 1) {
+            auto formatter{make_formatter()};
+            std::string buffer;
+
+            for (size_t chunk{0}; chunk < chunk_count; chunk++) {
+                format_chunk(chunk, formatter, buffer);
+                if (!display_chunk(chunk, buffer))
+                    return false;
+            }
+            return true;
+        }
+
+        /* Finished chunks wait in a bounded window until their turn comes */
+        const auto window{2 * thread_count};
+        std::vector<std::string> buffers(window);
+        std::vector<bool> ready(window, false);
+        size_t next_chunk{0};
+        size_t displayed{0};
+        bool stopped{false};
+        std::mutex mutex;
+        std::condition_variable produced, consumed;
+
+        const auto worker = [&] {
+            auto formatter{make_formatter()};
+            std::string buffer;
+
+            for (;;) {
+                size_t chunk;
+                {
+                    std::unique_lock lock{mutex};
+                    if (next_chunk == chunk_count || stopped)
+                        return;
+                    chunk = next_chunk++;
+                    consumed.wait(lock, [&] { return chunk < displayed + window || stopped; });
+                    if (stopped)
+                        return;
+                }
+
+                format_chunk(chunk, formatter, buffer);
+
+                {
+                    std::lock_guard lock{mutex};
+                    std::swap(buffers[chunk % window], buffer);
+                    ready[chunk % window] = true;
+                }
+                produced.notify_one();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t i{0}; i < std::min(thread_count, chunk_count); i++)
+            workers.emplace_back(worker);
+
+        std::string buffer;
+        for (size_t chunk{0}; chunk < chunk_count && !stopped; chunk++) {
+            {
+                std::unique_lock lock{mutex};
+                produced.wait(lock, [&] { return static_cast<bool>(ready[chunk % window]); });
+                std::swap(buffers[chunk % window], buffer);
+                ready[chunk % window] = false;
+                displayed++;
+            }
+            consumed.notify_all();
+            if (!display_chunk(chunk, buffer)) {
+                std::lock_guard lock{mutex};
+                stopped = true;
+            }
+        }
+        consumed.notify_all();
+
+        std::for_each(begin(workers), end(workers), [](std::thread& worker) {
+            worker.join();
+        });
+        return !stopped;
+    }
+
+    /* Kinds of frames exchanged by a coordinator and its workers. A frame
+     * is its kind and the size of its payload as little-endian 64-bit words,
+     * followed by the payload. Work frames carry the first and the last
+     * ordinal of a range; result frames carry the same two ordinals followed
+     * by the formatted rows. Stop frames have no payload. */
+    enum class frame_kind : uint64_t { work = 1, result = 2, stop = 3 };
+
+    void append_word(std::string& data, uint64_t value) {
+        for (size_t byte{0}; byte < 8; byte++)
+            data.push_back(static_cast<char>(value >> (8 * byte)));
+    }
+
+    uint64_t read_word(const char* data) {
+        uint64_t value{0};
+        for (size_t byte{0}; byte < 8; byte++)
+            value |= uint64_t{static_cast<uint8_t>(data[byte])} << (8 * byte);
+        return value;
+    }
+
+    /* Sends a frame whose payload starts with the given words */
+    bool send_frame(int socket, frame_kind kind, const std::vector<uint64_t>& words,
+                    std::string_view rows = {}) {
+        std::string head;
+        append_word(head, static_cast<uint64_t>(kind));
+        append_word(head, 8 * words.size() + rows.size());
+        for (const auto word : words)
+            append_word(head, word);
+
+        for (auto data : {std::string_view{head}, rows}) {
+            while (!data.empty()) {
+                const auto sent{::send(socket, data.data(), data.size(), MSG_NOSIGNAL)};
+                if (sent < 0 && errno == EINTR)
+                    continue;
+                if (sent <= 0)
+                    return false;
+                data.remove_prefix(static_cast<size_t>(sent));
+            }
+        }
+        return true;
+    }
+
+    /* Receives a whole frame, missing when the peer is gone */
+    std::optional<std::pair<frame_kind, std::string>> receive_frame(int socket) {
+        const auto receive = [socket](char* data, size_t size) {
+            while (size != 0) {
+                const auto received{::recv(socket, data, size, 0)};
+                if (received < 0 && errno == EINTR)
+                    continue;
+                if (received <= 0)
+                    return false;
+                data += received;
+                size -= static_cast<size_t>(received);
+            }
+            return true;
+        };
+
+        std::array<char, 16> head{};
+        if (!receive(head.data(), head.size()))
+            return std::nullopt;
+        std::string payload(read_word(head.data() + 8), '\0');
+        if (!receive(payload.data(), payload.size()))
+            return std::nullopt;
+        return std::pair{static_cast<frame_kind>(read_word(head.data())), std::move(payload)};
+    }
+
+    /* Formats the ranges requested by a coordinator until told to stop */
+    template<typename FormatterFactory>
+    [[noreturn]] void serve_work(int socket, const FormatterFactory& make_formatter) {
+        auto formatter{make_formatter()};
+        std::string buffer;
+
+        for (;;) {
+            const auto frame{receive_frame(socket)};
+            if (!frame || frame->first != frame_kind::work || frame->second.size() != 16)
+                ::_exit(frame && frame->first == frame_kind::stop ? EXIT_SUCCESS : EXIT_FAILURE);
+
+            const auto first{read_word(frame->second.data())};
+            const auto last{read_word(frame->second.data() + 8)};
+            formatter(first, last, buffer);
+            if (!send_frame(socket, frame_kind::result, {first, last}, buffer))
+                ::_exit(EXIT_FAILURE);
+        }
+    }
+
+    /* Displays the combinations in range [first, last) formatted by worker
+     * processes, by ascending ordinal. Workers are forked with the compiled
+     * circuit and serve aligned chunks over sockets until stopped. Each one
+     * has up to two chunks requested at a time and gets another whenever it
+     * returns one, within a window of chunks ahead of the next displayed. */
+    template<typename FormatterFactory>
+    bool coordinate_workers(size_t first, size_t last, size_t chunk_lanes, size_t worker_count,
+                            output_writer& output, checkpoint_writer* progress,
+                            const FormatterFactory& make_formatter) {
+        const auto first_chunk{first / chunk_lanes};
+        const auto chunk_count{first < last ? (last + chunk_lanes - 1) / chunk_lanes - first_chunk : 0};
+        const auto chunk_start = [&](size_t chunk) {
+            return std::max(first, (first_chunk + chunk) * chunk_lanes);
+        };
+        const auto chunk_end = [&](size_t chunk) {
+            return std::min(last, (first_chunk + chunk + 1) * chunk_lanes);
+        };
+
+        constexpr size_t requests_per_worker{2};
+        std::vector<int> sockets;
+        std::vector<pid_t> workers;
+        for (size_t i{0}; i < std::min(worker_count, chunk_count); i++) {
+            std::array<int, 2> ends{};
+            if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, ends.data()) != 0)
+                break;
+            const auto worker{::fork()};
+            if (worker == 0) {
+                for (const auto socket : sockets)
+                    ::close(socket);
+                ::close(ends[0]);
+                serve_work(ends[1], make_formatter);
+            }
+            ::close(ends[1]);
+            if (worker < 0) {
+                ::close(ends[0]);
+                break;
+            }
+            sockets.push_back(ends[0]);
+            workers.push_back(worker);
+        }
+
+        const auto window{requests_per_worker * 2 * workers.size()};
+        std::vector<size_t> requested(workers.size(), 0);
+        std::map<size_t, std::string> finished;
+        size_t next_chunk{0};
+        size_t displayed{0};
+        bool failed{workers.empty() && chunk_count != 0};
+        bool written{true};
+
+        while (!failed && displayed < chunk_count) {
+            for (size_t worker{0}; worker < workers.size() && !failed; worker++) {
+                while (!failed && requested[worker] < requests_per_worker && next_chunk < chunk_count
+                       && next_chunk < displayed + window) {
+                    failed = !send_frame(sockets[worker], frame_kind::work,
+                                         {chunk_start(next_chunk), chunk_end(next_chunk)});
+                    requested[worker]++;
+                    next_chunk++;
+                }
+            }
+
+            std::vector<pollfd> events;
+            for (const auto socket : sockets)
+                events.push_back({socket, POLLIN, 0});
+            if (!failed && ::poll(events.data(), events.size(), -1) < 0 && errno != EINTR)
+                failed = true;
+            if (failed)
+                break;
+
+            for (size_t worker{0}; worker < workers.size() && !failed; worker++) {
+                if (events[worker].revents == 0)
+                    continue;
+                auto frame{receive_frame(sockets[worker])};
+                failed = !frame || frame->first != frame_kind::result || frame->second.size() < 16
+                         || requested[worker] == 0;
+                if (failed)
+                    break;
+                const auto chunk{read_word(frame->second.data()) / chunk_lanes - first_chunk};
+                finished.emplace(chunk, std::move(frame->second));
+                requested[worker]--;
+            }
+
+            for (auto ready{finished.find(displayed)}; !failed && ready != end(finished);
+                 ready = finished.find(displayed)) {
+                written = output.write(std::string_view{ready->second}.substr(16))
+                          && (!progress || progress->advance(chunk_end(displayed), output,
+                                                             displayed + 1 == chunk_count));
+                failed = !written;
+                if (failed)
+                    break;
+                count_statistic(statistics().rows, chunk_end(displayed) - chunk_start(displayed));
+                finished.erase(ready);
+                displayed++;
+            }
+        }
+
+        for (size_t worker{0}; worker < workers.size(); worker++) {
+            if (failed)
+                ::kill(workers[worker], SIGKILL);
+            else
+                send_frame(sockets[worker], frame_kind::stop, {});
+            ::close(sockets[worker]);
+            ::waitpid(workers[worker], nullptr, 0);
+        }
+
+        if (failed && written)
+            error::print_worker_message();
+        return !failed;
+    }
+
+    /* Signal connections needed to propagate changes of single signals */
+    struct event_graph {
+        std::vector<uint32_t> fanout_offsets;
+        std::vector<uint32_t> fanouts;
+        std::vector<uint32_t> levels;
+        std::vector<uint32_t> column_offsets;
+        std::vector<uint32_t> columns;
+        size_t level_count;
+    };
+
+    /* Collects the gates reading each slot together with the logic levels of gates */
+    event_graph get_event_graph(const netlist& compiled) {
+        const scoped_timer timer{phase::compile};
+        event_graph events;
+        const auto slot_count{compiled.labels.size()};
+
+        events.level_count = compiled.level_offsets.size();
+        events.levels.resize(compiled.gates.size());
+        for (size_t level{1}; level < compiled.level_offsets.size(); level++)
+            std::fill(std::next(begin(events.levels), compiled.level_offsets[level - 1]),
+                      std::next(begin(events.levels), compiled.level_offsets[level]), level - 1);
+
+        events.fanout_offsets.assign(slot_count + 1, 0);
+        for (const auto input : compiled.fanins)
+            events.fanout_offsets[input + 1]++;
+        std::partial_sum(begin(events.fanout_offsets), end(events.fanout_offsets),
+                         begin(events.fanout_offsets));
+
+        events.fanouts.resize(compiled.fanins.size());
+        auto next{events.fanout_offsets};
+        for (uint32_t gate{0}; gate < compiled.gates.size(); gate++) {
+            const auto& record{compiled.gates[gate]};
+            for (uint32_t i{0}; i < record.fanin_count; i++)
+                events.fanouts[next[compiled.fanins[record.fanin_offset + i]]++] = gate;
+        }
+
+        /* A slot may be displayed in any number of columns */
+        events.column_offsets.assign(slot_count + 1, 0);
+        for (const auto slot : compiled.columns)
+            events.column_offsets[slot + 1]++;
+        std::partial_sum(begin(events.column_offsets), end(events.column_offsets),
+                         begin(events.column_offsets));
+
+        events.columns.resize(compiled.columns.size());
+        next = events.column_offsets;
+        for (uint32_t column{0}; column < compiled.columns.size(); column++)
+            events.columns[next[compiled.columns[column]]++] = column;
+
+        return events;
+    }
+
+    /* Enumerates combinations in Gray-code order, so that a single input
+     * changes between consecutive combinations, and re-evaluates only the
+     * gates the change reaches. Rows are stored at their natural position
+     * within the range, so the output keeps ascending order. */
+    class gray_walker {
+    public:
+        gray_walker(const netlist& compiled, const event_graph& events)
+                : compiled{compiled}, events{events}, values(compiled.labels.size(), 0),
+                  queued(compiled.gates.size(), false), buckets(events.level_count),
+                  row(compiled.columns.size() + 1, '0') {
+            row.back() = '\n';
+
+            /* Starting combination: all inputs unset, matching the digits in the row */
+            for (const auto& gate : compiled.gates)
+                update_gate(gate);
+        }
+
+        void operator()(size_t first, size_t last, std::string& buffer) {
+            const scoped_timer timer{phase::evaluate};
+            const counted_section counting;
+            const auto width{row.size()};
+            buffer.resize((last - first) * width);
+
+            /* The walk covers the smallest aligned power of two containing
+             * the range, keeping the rows within the range */
+            const auto window_bits{static_cast<size_t>(std::bit_width(first ^ (last - 1)))};
+            const auto base{first & ~((size_t{1} << window_bits) - 1)};
+            const auto store_row = [&] {
+                if (ordinal >= first && ordinal < last)
+                    std::copy(begin(row), end(row), buffer.data() + (ordinal - first) * width);
+            };
+
+            /* Move to the first combination of the window */
+            for (auto changed{ordinal ^ base}; changed != 0; changed &= changed - 1)
+                flip_input(static_cast<size_t>(std::countr_zero(changed)));
+            ordinal = base;
+            propagate();
+            store_row();
+
+            for (size_t step{1}; step < size_t{1} << window_bits; step++) {
+                const auto bit{static_cast<size_t>(std::countr_zero(step))};
+                flip_input(bit);
+                propagate();
+                ordinal ^= size_t{1} << bit;
+                store_row();
+            }
+            count_statistic(statistics().gate_evaluations, std::exchange(evaluated, 0));
+        }
+
+    private:
+        void set_value(logic::slot_t slot, uint8_t value) {
+            values[slot] = value;
+            for (auto i{events.column_offsets[slot]}; i < events.column_offsets[slot + 1]; i++)
+                row[events.columns[i]] = static_cast<char>('0' | value);
+        }
+
+        void schedule_fanouts(logic::slot_t slot) {
+            for (auto i{events.fanout_offsets[slot]}; i < events.fanout_offsets[slot + 1]; i++) {
+                const auto gate{events.fanouts[i]};
+                if (!queued[gate]) {
+                    queued[gate] = true;
+                    const auto level{events.levels[gate]};
+                    buckets[level].push_back(gate);
+                    lowest_level = std::min(lowest_level, level);
+                    highest_level = std::max(highest_level, level);
+                }
+            }
+        }
+
+        void flip_input(size_t bit) {
+            const auto slot{static_cast<logic::slot_t>(bit)};
+            set_value(slot, values[slot] ^ 1);
+            schedule_fanouts(slot);
+        }
+
+        bool update_gate(const logic::gate_record& gate) {
+            evaluated++;
+            const auto value{static_cast<uint8_t>(logic::evaluate(
+                    gate.op, values.data(), compiled.fanins.data() + gate.fanin_offset, gate.fanin_count))};
+            if (value == values[gate.output])
+                return false;
+            set_value(gate.output, value);
+            return true;
+        }
+
+        /* Re-evaluates scheduled gates by ascending level, which schedules
+         * the readers of every gate whose value changes */
+        void propagate() {
+            for (auto level{lowest_level}; level <= highest_level && level < buckets.size(); level++) {
+                for (size_t i{0}; i < buckets[level].size(); i++) {
+                    const auto gate{buckets[level][i]};
+                    queued[gate] = false;
+                    if (update_gate(compiled.gates[gate]))
+                        schedule_fanouts(compiled.gates[gate].output);
+                }
+                buckets[level].clear();
+            }
+
+            lowest_level = UINT32_MAX;
+            highest_level = 0;
+        }
+
+        const netlist& compiled;
+        const event_graph& events;
+        std::vector<uint8_t> values;
+        std::vector<bool> queued;
+        std::vector<std::vector<uint32_t>> buckets;
+        std::string row;
+        size_t ordinal{0};
+        uint64_t evaluated{0};
+        uint32_t lowest_level{UINT32_MAX};
+        uint32_t highest_level{0};
+    };
+
+    /* Name of the evaluation function in compiled circuits */
+    constexpr const char* native_symbol{"nysa_evaluate"};
+
+    /* Emits C++ code evaluating the gates of a circuit in order, one
+     * expression over whole blocks per gate */
+    std::string generate_native_source(const netlist& compiled) {
+        std::string source{
+                "#include <cstdint>\n"
+                "typedef uint64_t block __attribute__((vector_size(64), aligned(8)));\n"
+                "extern \"C\" void "};
+        source += native_symbol;
+        source += "(block* v) {\n";
+
+        for (const auto& gate : compiled.gates) {
+            const auto* const inputs{compiled.fanins.data() + gate.fanin_offset};
+            const auto negated{gate.op == logic::opcode::lnot || gate.op == logic::opcode::lnand
+                               || gate.op == logic::opcode::lnor};
+            const auto* const separator{gate.op == logic::opcode::lxor ? " ^ "
+                                        : gate.op == logic::opcode::lor || gate.op == logic::opcode::lnor ? " | "
+                                        : " & "};
+
+            source += "    v[" + std::to_string(gate.output) + "] = " + (negated ? "~(" : "(");
+            for (uint32_t i{0}; i < gate.fanin_count; i++)
+                source += (i == 0 ? "v[" : std::string{separator} + "v[") + std::to_string(inputs[i]) + "]";
+            source += ");\n";
+        }
+
+        source += "}\n";
+        return source;
+    }
+
+    /* Directory caching compiled circuits between runs, if the user has one.
+     * There is no shared fallback, whose content other users could choose. */
+    std::optional<std::string> native_cache_directory() {
+        if (const auto* cache{std::getenv("XDG_CACHE_HOME")}; cache && *cache)
+            return std::string{cache} + "/nysa";
+        if (const auto* home{std::getenv("HOME")}; home && *home)
+            return std::string{home} + "/.cache/nysa";
+        return std::nullopt;
+    }
+
+    /* Whether a path, not followed if a link, is a file of the given type
+     * owned by the effective user and writable by nobody else */
+    bool owned_privately(const std::string& path, mode_t type) {
+        struct stat status{};
+        return ::lstat(path.c_str(), &status) == 0 && (status.st_mode & S_IFMT) == type
+               && status.st_uid == ::geteuid() && (status.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+    }
+
+    /* Description of the processor targeted by -march=native: the model
+     * and the features of the first processor listed by the kernel */
+    std::string host_processor() {
+        const auto descriptor{::open("/proc/cpuinfo", O_RDONLY)};
+        if (descriptor < 0)
+            return {};
+        const auto text{read_all(descriptor)};
+        ::close(descriptor);
+
+        std::string description;
+        for (std::string_view rest{text}; !rest.empty();) {
+            const auto line_end{std::min(rest.find('\n'), rest.size())};
+            const auto line{rest.substr(0, line_end)};
+            if (line.empty())
+                break;
+            rest.remove_prefix(std::min(line_end + 1, rest.size()));
+
+            for (const std::string_view key : {"vendor_id", "model name", "flags", "CPU implementer", "CPU part",
+                                               "Features"})
+                if (line.starts_with(key))
+                    description += std::string{line} + "\n";
+        }
+        return description;
+    }
+
+    /* Writes a new file, failing if anything exists under its name, links
+     * included. Unlike the output writer, it does not count the bytes. */
+    bool write_file(const std::string& path, std::string_view data) {
+        const auto descriptor{::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW, 0600)};
+        if (descriptor < 0)
+            return false;
+
+        while (!data.empty()) {
+            const auto written{::write(descriptor, data.data(), data.size())};
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written < 0)
+                break;
+            data.remove_prefix(static_cast<size_t>(written));
+        }
+        return ::close(descriptor) == 0 && data.empty();
+    }
+
+    /* Runs a program with arguments and waits for its successful completion */
+    bool run_program(std::vector<std::string> arguments) {
+        std::vector<char*> pointers;
+        for (auto& argument : arguments)
+            pointers.push_back(argument.data());
+        pointers.push_back(nullptr);
+
+        const auto child{::fork()};
+        if (child < 0)
+            return false;
+        if (child == 0) {
+            ::execvp(pointers[0], pointers.data());
+            ::_exit(127);
+        }
+
+        int status;
+        while (::waitpid(child, &status, 0) < 0)
+            if (errno != EINTR)
+                return false;
+        return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    /* Circuit evaluated by native code, compiled with the compiler given by
+     * the CXX environment variable or c++. Shared objects are cached under a
+     * hash of their source, compiler and processor, so a netlist is compiled
+     * only once on a machine. Only a cache directory and objects owned by the
+     * user and writable by nobody else are trusted; without one, the object
+     * is built in a private temporary directory removed once loaded. */
+    class native_circuit {
+    public:
+        using function = void (*)(logic::binblock*);
+
+        explicit native_circuit(const netlist& compiled)
+                : columns{compiled.columns}, input_count{compiled.input_count}, gate_count{compiled.gates.size()} {
+            static_assert(sizeof(logic::binblock) == 64);
+            const scoped_timer timer{phase::compile};
+
+            const auto* const variable{std::getenv("CXX")};
+            const std::string compiler{variable && *variable ? variable : "c++"};
+            const std::vector<std::string> flags{"-O2", "-march=native", "-shared", "-fPIC"};
+            const auto source{generate_native_source(compiled)};
+
+            /* Hash of everything the shared object depends on, including
+             * the processor that native code is tuned for */
+            std::string identity{compiler};
+            for (const auto& flag : flags)
+                identity += " " + flag;
+            identity += "\n" + host_processor();
+            const auto hash{hash_bytes(source, hash_bytes(identity))};
+
+            auto directory{native_cache_directory()};
+            if (directory) {
+                for (auto slash{directory->find('/', 1)}; slash != std::string::npos;
+                     slash = directory->find('/', slash + 1))
+                    ::mkdir(directory->substr(0, slash).c_str(), 0700);
+                ::mkdir(directory->c_str(), 0700);
+                if (!owned_privately(*directory, S_IFDIR))
+                    directory.reset();
+            }
+
+            const auto cached{directory.has_value()};
+            if (!cached) {
+                std::string pattern{"/tmp/nysa-XXXXXX"};
+                if (!::mkdtemp(pattern.data()))
+                    return;
+                directory = pattern;
+            }
+            const auto library_path{*directory + "/" + hash_digits(hash) + ".so"};
+
+            if (!cached || !owned_privately(library_path, S_IFREG))
+                build_library(compiler, flags, source, library_path);
+            if (owned_privately(library_path, S_IFREG))
+                library = ::dlopen(library_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+            if (library)
+                evaluate = reinterpret_cast<function>(::dlsym(library, native_symbol));
+
+            if (!cached) {
+                ::unlink(library_path.c_str());
+                ::rmdir(directory->c_str());
+            }
+        }
+
+        native_circuit(const native_circuit&) = delete;
+        native_circuit& operator=(const native_circuit&) = delete;
+
+        ~native_circuit() {
+            if (library)
+                ::dlclose(library);
+        }
+
+        bool is_open() const {
+            return evaluate != nullptr;
+        }
+
+        std::vector<logic::slot_t> columns;
+        size_t input_count;
+        size_t gate_count;
+        function evaluate{nullptr};
+
+    private:
+        /* Builds a shared object under names of this process, renamed when complete */
+        static void build_library(const std::string& compiler, const std::vector<std::string>& flags,
+                                  const std::string& source, const std::string& library_path) {
+            const auto temporary{library_path + "." + std::to_string(::getpid())};
+            ::unlink((temporary + ".cc").c_str());
+            if (!write_file(temporary + ".cc", source)) {
+                ::unlink((temporary + ".cc").c_str());
+                return;
+            }
+
+            std::vector<std::string> arguments{compiler};
+            arguments.insert(end(arguments), begin(flags), end(flags));
+            arguments.insert(end(arguments), {"-o", temporary, temporary + ".cc"});
+            const auto built{run_program(arguments)};
+            ::unlink((temporary + ".cc").c_str());
+            if (!built || ::rename(temporary.c_str(), library_path.c_str()) != 0)
+                ::unlink(temporary.c_str());
+        }
+
+        void* library{nullptr};
+    };
+
+    /* Evaluates all gates for a block by running the native code */
+    void compute_gates(const native_circuit& code, std::vector<logic::binblock>& values) {
+        code.evaluate(values.data());
+        count_statistic(statistics().gate_evaluations, code.gate_count * block_lanes);
+    }
+
+    /* Displays combinations of a circuit evaluated a block of lanes at a
+     * time, handing the chunk size and a formatter factory to a display */
+    template<typename Circuit, typename Display>
+    bool print_circuit_blocks(const Circuit& circuit, size_t slot_count, const Display& display) {
+        const auto width{circuit.columns.size() + 1};
+        const auto chunk_lanes{std::max<size_t>(1, chunk_bytes / (width * block_lanes)) * block_lanes};
+
+        return display(chunk_lanes, [&] {
+            return [&circuit, values = std::vector<logic::binblock>(slot_count)]
+                    (size_t first, size_t last, std::string& buffer) mutable {
+                format_circuit_outputs(circuit, values, first, last, buffer);
+            };
+        });
+    }
+
+    /* Part of the combinations enumerated by a run: the given range, the
+     * given shard of all combinations, or all of them */
+    std::pair<uint64_t, uint64_t> enumerated_range(const options& settings, uint64_t combinations) {
+        if (settings.range)
+            return *settings.range;
+        if (settings.shard) {
+            using wide = unsigned __int128;
+            const auto [index, count]{*settings.shard};
+            return {static_cast<uint64_t>(wide{combinations} * index / count),
+                    static_cast<uint64_t>(wide{combinations} * (index + 1) / count)};
+        }
+        return {0, combinations};
+    }
+
+    std::string part_description(const options& settings) {
+        if (settings.range)
+            return " range " + std::to_string(settings.range->first) + ":" + std::to_string(settings.range->second);
+        if (settings.shard)
+            return " shard " + std::to_string(settings.shard->first) + "/" + std::to_string(settings.shard->second);
+        return "";
+    }
+
+    /* First line of the output of a range, identifying its place among
+     * all combinations of a netlist */
+    struct range_header {
+        uint64_t first;
+        uint64_t last;
+        uint64_t combinations;
+        uint64_t netlist_hash;
+    };
+
+    std::string format_range_header(const range_header& header) {
+        return "# nysa range " + std::to_string(header.first) + ":" + std::to_string(header.last) + " of "
+               + std::to_string(header.combinations) + " netlist " + hash_digits(header.netlist_hash) + "\n";
+    }
+
+    std::optional<range_header> parse_range_header(std::string_view line) {
+        range_header header{};
+        const auto read_number = [&](std::string_view prefix, uint64_t& value, int base) {
+            if (!line.starts_with(prefix))
+                return false;
+            line.remove_prefix(prefix.size());
+            const auto [end, status]{std::from_chars(line.data(), line.data() + line.size(), value, base)};
+            line.remove_prefix(static_cast<size_t>(end - line.data()));
+            return status == std::errc{};
+        };
+
+        if (read_number("# nysa range ", header.first, 10) && read_number(":", header.last, 10)
+            && read_number(" of ", header.combinations, 10) && read_number(" netlist ", header.netlist_hash, 16)
+            && line == "\n" && header.first <= header.last && header.last <= header.combinations)
+            return header;
+        return std::nullopt;
+    }
+
+    bool print_all_circuit_outputs(const netlist& compiled, const options& settings, output_writer& output,
+                                   uint64_t netlist_hash, checkpoint_writer* progress) {
+        /* Ordinals of the combinations must fit in 64 bits */
+        if (compiled.input_count >= 64) {
+            error::print_input_count_message(compiled.input_count);
+            return false;
+        }
+
+        const auto combinations{size_t{1} << compiled.input_count};
+        const auto width{compiled.columns.size() + 1};
+        const auto [first, last]{enumerated_range(settings, combinations)};
+        const auto start{settings.resume ? progress->progress().next_ordinal : first};
+
+        if (last > combinations) {
+            error::print_range_message(first, last, combinations);
+            return false;
+        }
+        if (start < first || start > last) {
+            error::print_checkpoint_mismatch_message(*settings.checkpoint);
+            return false;
+        }
+        if ((settings.range || settings.shard) && !settings.resume
+            && !output.write(format_range_header({first, last, combinations, netlist_hash})))
+            return false;
+
+        /* Chunks are formatted by threads of this process, or by worker
+         * processes in the coordinator mode */
+        const auto display = [&](size_t chunk_lanes, const auto& make_formatter) {
+            if (settings.command == "coordinator")
+                return coordinate_workers(start, last, chunk_lanes, settings.workers, output, progress,
+                                          make_formatter);
+            return print_chunks(start, last, chunk_lanes, settings.threads, output, progress, make_formatter);
+        };
+
+        if (settings.gray) {
+            /* Gray-code chunks span whole aligned powers of two */
+            size_t chunk_lanes{1};
+            while (chunk_lanes < combinations && 2 * chunk_lanes * width <= chunk_bytes)
+                chunk_lanes *= 2;
+
+            const auto events{get_event_graph(compiled)};
+            return display(chunk_lanes, [&] {
+                return gray_walker{compiled, events};
+            });
+        }
+
+        if (settings.jit) {
+            const native_circuit code{compiled};
+            if (!code.is_open()) {
+                error::print_native_code_message();
+                return false;
+            }
+            return print_circuit_blocks(code, compiled.labels.size(), display);
+        }
+
+        if (settings.aig) {
+            const auto graph{lower_to_aig(compiled)};
+            return print_circuit_blocks(graph, graph.slot_count(), display);
+        }
+
+        return print_circuit_blocks(compiled, compiled.labels.size(), display);
+    }
+
+    /* Reader of fixed-size records, or of lines if no size is given, taken
+     * from a file descriptor through a buffer of bounded size */
+    class record_reader {
+    public:
+        record_reader(int descriptor, size_t record_size)
+                : descriptor{descriptor}, record_size{record_size} {}
+
+        /* Next record, possibly shorter than the record size at the end of
+         * the input. Returns nothing once the input is exhausted. */
+        std::optional<std::string_view> next() {
+            for (;;) {
+                const std::string_view pending{buffer.data() + start, buffer.size() - start};
+                const auto size{record_size != 0 ? record_size : pending.find('\n')};
+
+                if (size < pending.size() || (record_size != 0 && size == pending.size())) {
+                    start += size + (record_size == 0);
+                    return pending.substr(0, size);
+                }
+                if (at_end) {
+                    start = buffer.size();
+                    return pending.empty() ? std::nullopt : std::optional{pending};
+                }
+                fill();
+            }
+        }
+
+    private:
+        void fill() {
+            constexpr size_t block_size{1 << 20};
+
+            buffer.erase(0, start);
+            start = 0;
+
+            const auto size{buffer.size()};
+            buffer.resize(size + std::max(block_size, record_size));
+
+            ssize_t count;
+            do {
+                count = ::read(descriptor, buffer.data() + size, buffer.size() - size);
+            } while (count < 0 && errno == EINTR);
+
+            buffer.resize(size + static_cast<size_t>(std::max<ssize_t>(count, 0)));
+            at_end = count <= 0;
+        }
+
+        int descriptor;
+        size_t record_size;
+        std::string buffer;
+        size_t start{0};
+        bool at_end{false};
+    };
+
+    bool print_vector_outputs(const gate_graph& circuit, const netlist& compiled,
+                              const options& settings, output_writer& output) {
+
+        /* Inputs of the vectors that the displayed signals depend on */
+        sigvector input_labels;
+        for (sig_t signal{0}; signal < static_cast<sig_t>(circuit.size()); signal++)
+            if (!circuit.contains(signal))
+                input_labels.push_back(circuit.labels[signal]);
+        std::sort(begin(input_labels), end(input_labels));
+
+        std::vector<std::pair<size_t, logic::slot_t>> used_inputs;
+        for (logic::slot_t slot{0}; slot < compiled.input_count; slot++) {
+            const auto position{std::lower_bound(begin(input_labels), end(input_labels), compiled.labels[slot])};
+            used_inputs.emplace_back(static_cast<size_t>(position - begin(input_labels)), slot);
+        }
+
+        const auto descriptor{::open(settings.vectors->c_str(), O_RDONLY)};
+        if (descriptor < 0) {
+            error::print_vectors_file_message(*settings.vectors);
+            return false;
+        }
+
+        const auto record_size{settings.binary_vectors ? (input_labels.size() + 7) / 8 : 0};
+        record_reader reader{descriptor, record_size};
+        std::vector<uint8_t> digits(input_labels.size());
+        std::optional<and_inverter_graph> graph;
+        if (settings.aig)
+            graph = lower_to_aig(compiled);
+
+        std::vector<logic::binblock> values(graph ? graph->slot_count() : compiled.labels.size());
+        const auto width{compiled.columns.size() + 1};
+        std::string buffer;
+        size_t lanes{0};
+        uint64_t written_rows{0};
+        bool valid{true};
+
+        const auto flush_block = [&] {
+            const auto size{buffer.size()};
+            buffer.resize(size + lanes * width);
+            {
+                const scoped_timer timer{phase::evaluate};
+                const counted_section counting;
+                graph ? compute_gates(*graph, values) : compute_gates(compiled, values);
+            }
+            {
+                const scoped_timer timer{phase::format};
+                graph ? format_block(*graph, values, lanes, buffer.data() + size)
+                      : format_block(compiled, values, lanes, buffer.data() + size);
+            }
+            count_statistic(statistics().rows, lanes);
+
+            for (logic::slot_t slot{0}; slot < compiled.input_count; slot++)
+                values[slot].fill(0);
+            lanes = 0;
+
+            if (buffer.size() >= chunk_bytes) {
+                valid = output.write(buffer);
+                written_rows += buffer.size() / width;
+                buffer.clear();
+            }
+        };
+
+        /* Vectors are numbered from one, blank lines not being vectors */
+        uint64_t vector{0};
+        while (valid) {
+            const auto record{reader.next()};
+            if (!record)
+                break;
+
+            if (settings.binary_vectors) {
+                valid = record->size() == record_size;
+                for (size_t input{0}; valid && input < digits.size(); input++)
+                    digits[input] = ((*record)[input / 8] >> (input % 8)) & 1;
+            } else {
+                size_t count{0};
+                for (const auto c : *record) {
+                    if (c == '0' || c == '1') {
+                        if (count < digits.size())
+                            digits[count] = c - '0';
+                        count++;
+                    } else if (!is_blank(c)) {
+                        valid = false;
+                    }
+                }
+                if (count == 0 && valid)
+                    continue;
+                valid &= count == digits.size();
+            }
+
+            vector++;
+            if (!valid) {
+                error::print_invalid_vector_message(vector, input_labels.size(), written_rows);
+                break;
+            }
+
+            for (const auto& [input, slot] : used_inputs)
+                values[slot][lanes / word_lanes] |= logic::binword{digits[input]} << (lanes % word_lanes);
+            if (++lanes == block_lanes)
+                flush_block();
+        }
+
+        if (valid && lanes != 0)
+            flush_block();
+        valid = valid && output.write(buffer);
+        ::close(descriptor);
+
+        return valid;
+    }
+
+    /* Unsigned integer of arbitrary size, used for counting assignments */
+    struct big_count {
+        std::vector<uint32_t> limbs;
+
+        big_count& operator+=(const big_count& other) {
+            uint64_t carry{0};
+            limbs.resize(std::max(limbs.size(), other.limbs.size()), 0);
+            for (size_t i{0}; i < limbs.size(); i++) {
+                carry += uint64_t{limbs[i]} + (i < other.limbs.size() ? other.limbs[i] : 0);
+                limbs[i] = static_cast<uint32_t>(carry);
+                carry >>= 32;
+            }
+            if (carry != 0)
+                limbs.push_back(static_cast<uint32_t>(carry));
+            return *this;
+        }
+
+        big_count shifted(size_t bits) const {
+            if (limbs.empty())
+                return {};
+
+            big_count result;
+            result.limbs.assign(bits / 32, 0);
+            uint32_t carry{0};
+            for (const auto limb : limbs) {
+                const auto wide{(uint64_t{limb} << (bits % 32)) | carry};
+                result.limbs.push_back(static_cast<uint32_t>(wide));
+                carry = static_cast<uint32_t>(wide >> 32);
+            }
+            if (carry != 0)
+                result.limbs.push_back(carry);
+            return result;
+        }
+
+        std::string to_string() const {
+            auto digits{limbs};
+            std::string result;
+
+            /* Repeated division by 10^9 yields groups of nine decimal digits */
+            while (!digits.empty()) {
+                uint64_t remainder{0};
+                for (auto limb{digits.rbegin()}; limb != digits.rend(); limb++) {
+                    const auto current{(remainder << 32) | *limb};
+                    *limb = static_cast<uint32_t>(current / 1000000000);
+                    remainder = current % 1000000000;
+                }
+                while (!digits.empty() && digits.back() == 0)
+                    digits.pop_back();
+
+                auto group{std::to_string(remainder)};
+                if (!digits.empty())
+                    group.insert(0, 9 - group.size(), '0');
+                result.insert(0, group);
+            }
+
+            return result.empty() ? "0" : result;
+        }
+    };
+
+    /* Reduced ordered binary decision diagrams sharing a single node store.
+     * Nodes are unique per variable, results of operations are memoized in a
+     * computed cache and variables may be reordered by sifting. Nodes are
+     * reference counted; unreferenced nodes are reclaimed by collect_garbage. */
+    class bdd_manager {
+    public:
+        using node_t = uint32_t;
+
+        static constexpr node_t zero{0};
+        static constexpr node_t one{1};
+
+        explicit bdd_manager(size_t variable_count)
+                : tables(variable_count), levels(variable_count), variables(variable_count) {
+            nodes.push_back({terminal, zero, zero, no_node, 1});
+            nodes.push_back({terminal, one, one, no_node, 1});
+            std::iota(begin(levels), end(levels), 0);
+            std::iota(begin(variables), end(variables), 0);
+            for (auto& table : tables)
+                table.buckets.assign(initial_buckets, no_node);
+            cache.resize(initial_cache);
+        }
+
+        /* Function equal to a single variable */
+        node_t variable(uint32_t var) {
+            return make(var, zero, one);
+        }
+
+        node_t conj(node_t f, node_t g) {
+            return apply(operation::conj, f, g);
+        }
+
+        node_t disj(node_t f, node_t g) {
+            return apply(operation::disj, f, g);
+        }
+
+        node_t parity(node_t f, node_t g) {
+            return apply(operation::parity, f, g);
+        }
+
+        node_t negate(node_t f) {
+            return apply(operation::parity, f, one);
+        }
+
+        void ref(node_t f) {
+            nodes[f].refs++;
+        }
+
+        void deref(node_t f) {
+            nodes[f].refs--;
+        }
+
+        /* Number of nodes allocated, including unreferenced ones */
+        size_t size() const {
+            return nodes.size() - free_nodes.size();
+        }
+
+        /* Frees every node that is not reachable from a referenced node */
+        void collect_garbage() {
+            std::vector<node_t> dead;
+            for (auto& table : tables)
+                for (const auto head : table.buckets)
+                    for (auto f{head}; f != no_node; f = nodes[f].next)
+                        if (nodes[f].refs == 0)
+                            dead.push_back(f);
+
+            std::for_each(begin(dead), end(dead), [&](node_t f) {
+                release(f);
+            });
+            clear_cache();
+        }
+
+        /* Moves every variable, largest levels first, to the position that
+         * minimizes the number of nodes, one adjacent swap at a time */
+        void reorder() {
+            collect_garbage();
+
+            std::vector<uint32_t> order(variables.size());
+            std::iota(begin(order), end(order), 0);
+            std::sort(begin(order), end(order), [&](uint32_t lhs, uint32_t rhs) {
+                return tables[lhs].count > tables[rhs].count;
+            });
+
+            for (const auto var : order)
+                sift(var);
+        }
+
+        /* Number of assignments of all variables satisfying a function */
+        big_count satisfy_count(node_t f) const {
+            std::unordered_map<node_t, big_count> counts;
+            return count_below(f, counts).shifted(level_of(f));
+        }
+
+        /* Values of variables of an assignment satisfying a function, variables
+         * the function does not depend on being unset. Empty if unsatisfiable. */
+        std::optional<std::vector<uint8_t>> satisfying_assignment(node_t f) const {
+            if (f == zero)
+                return std::nullopt;
+
+            std::vector<uint8_t> assignment(variables.size(), 0);
+            while (f != one) {
+                const auto& current{nodes[f]};
+                assignment[current.var] = current.hi != zero;
+                f = current.hi != zero ? current.hi : current.lo;
+            }
+            return assignment;
+        }
+
+        /* Visits disjoint cubes covering a function; a cube assigns 0, 1 or
+         * nothing (value 2) to every variable */
+        template<typename Visitor>
+        void for_each_cube(node_t f, Visitor&& visit) const {
+            std::vector<uint8_t> cube(variables.size(), 2);
+            visit_cubes(f, cube, visit);
+        }
+
+    private:
+        enum class operation : uint8_t { conj, disj, parity };
+
+        static constexpr uint32_t terminal{UINT32_MAX};
+        static constexpr node_t no_node{UINT32_MAX};
+        static constexpr size_t initial_buckets{256};
+        static constexpr size_t initial_cache{1 << 16};
+
+        struct node {
+            uint32_t var;
+            node_t lo, hi;
+            node_t next;
+            uint32_t refs;
+        };
+
+        struct unique_table {
+            std::vector<node_t> buckets;
+            size_t count{0};
+        };
+
+        struct cache_entry {
+            node_t f{no_node}, g{no_node}, result{no_node};
+            operation op{operation::conj};
+        };
+
+        static size_t hash(node_t lo, node_t hi) {
+            return (uint64_t{lo} * 0x9E3779B97F4A7C15ull) ^ (uint64_t{hi} * 0xC2B2AE3D27D4EB4Full);
+        }
+
+        uint32_t level_of(node_t f) const {
+            return f <= one ? static_cast<uint32_t>(variables.size()) : levels[nodes[f].var];
+        }
+
+        /* Finds or creates the node of a variable with the given cofactors */
+        node_t make(uint32_t var, node_t lo, node_t hi) {
+            if (lo == hi)
+                return lo;
+
+            auto& table{tables[var]};
+            auto& head{table.buckets[hash(lo, hi) & (table.buckets.size() - 1)]};
+            for (auto f{head}; f != no_node; f = nodes[f].next)
+                if (nodes[f].lo == lo && nodes[f].hi == hi)
+                    return f;
+
+            node_t f;
+            if (!free_nodes.empty()) {
+                f = free_nodes.back();
+                free_nodes.pop_back();
+                nodes[f] = {var, lo, hi, head, 0};
+            } else {
+                f = static_cast<node_t>(nodes.size());
+                nodes.push_back({var, lo, hi, head, 0});
+            }
+            head = f;
+            nodes[lo].refs++;
+            nodes[hi].refs++;
+
+            if (++table.count > 2 * table.buckets.size())
+                rehash(table, 2 * table.buckets.size());
+            return f;
+        }
+
+        void rehash(unique_table& table, size_t bucket_count) {
+            std::vector<node_t> buckets(bucket_count, no_node);
+            for (const auto head : table.buckets) {
+                for (auto f{head}; f != no_node;) {
+                    const auto next{nodes[f].next};
+                    auto& bucket{buckets[hash(nodes[f].lo, nodes[f].hi) & (bucket_count - 1)]};
+                    nodes[f].next = bucket;
+                    bucket = f;
+                    f = next;
+                }
+            }
+            table.buckets = std::move(buckets);
+        }
+
+        void unlink(node_t f) {
+            auto& table{tables[nodes[f].var]};
+            auto* link{&table.buckets[hash(nodes[f].lo, nodes[f].hi) & (table.buckets.size() - 1)]};
+            while (*link != f)
+                link = &nodes[*link].next;
+            *link = nodes[f].next;
+            table.count--;
+        }
+
+        void link(node_t f) {
+            auto& table{tables[nodes[f].var]};
+            auto& head{table.buckets[hash(nodes[f].lo, nodes[f].hi) & (table.buckets.size() - 1)]};
+            nodes[f].next = head;
+            head = f;
+            if (++table.count > 2 * table.buckets.size())
+                rehash(table, 2 * table.buckets.size());
+        }
+
+        /* Frees an unreferenced node and the descendants only it referenced */
+        void release(node_t f) {
+            std::vector<node_t> pending{f};
+            while (!pending.empty()) {
+                const auto current{pending.back()};
+                pending.pop_back();
+
+                unlink(current);
+                free_nodes.push_back(current);
+                for (const auto child : {nodes[current].lo, nodes[current].hi})
+                    if (child > one && --nodes[child].refs == 0)
+                        pending.push_back(child);
+            }
+        }
+
+        void clear_cache() {
+            cache.assign(std::bit_ceil(std::max(initial_cache, size())), cache_entry{});
+        }
+
+        node_t apply(operation op, node_t f, node_t g) {
+            switch (op) {
+                case operation::conj:
+                    if (f == zero || g == zero)
+                        return zero;
+                    if (f == one || f == g)
+                        return g;
+                    if (g == one)
+                        return f;
+                    break;
+                case operation::disj:
+                    if (f == one || g == one)
+                        return one;
+                    if (f == zero || f == g)
+                        return g;
+                    if (g == zero)
+                        return f;
+                    break;
+                case operation::parity:
+                    if (f == g)
+                        return zero;
+                    if (f == zero)
+                        return g;
+                    if (g == zero)
+                        return f;
+                    if (f == one && g == one)
+                        return zero;
+                    break;
+            }
+
+            /* All operations are commutative */
+            if (f > g)
+                std::swap(f, g);
+
+            auto& entry{cache[(hash(f, g) ^ static_cast<size_t>(op)) & (cache.size() - 1)]};
+            if (entry.f == f && entry.g == g && entry.op == op)
+                return entry.result;
+
+            const auto level{std::min(level_of(f), level_of(g))};
+            const auto var{variables[level]};
+            const auto [f_lo, f_hi]{cofactors(f, level)};
+            const auto [g_lo, g_hi]{cofactors(g, level)};
+
+            const auto lo{apply(op, f_lo, g_lo)};
+            const auto hi{apply(op, f_hi, g_hi)};
+            const auto result{make(var, lo, hi)};
+
+            entry = {f, g, result, op};
+            return result;
+        }
+
+        std::pair<node_t, node_t> cofactors(node_t f, uint32_t level) const {
+            if (level_of(f) != level)
+                return {f, f};
+            return {nodes[f].lo, nodes[f].hi};
+        }
+
+        /* Exchanges the variables of two adjacent levels in place, so every
+         * node keeps denoting the same function */
+        void swap_levels(uint32_t level) {
+            const auto x{variables[level]};
+            const auto y{variables[level + 1]};
+
+            std::vector<node_t> moved;
+            for (auto& head : tables[x].buckets) {
+                for (auto f{head}; f != no_node; f = nodes[f].next)
+                    if (level_of(nodes[f].lo) == level + 1 || level_of(nodes[f].hi) == level + 1)
+                        moved.push_back(f);
+            }
+            std::for_each(begin(moved), end(moved), [&](node_t f) {
+                unlink(f);
+            });
+
+            std::swap(variables[level], variables[level + 1]);
+            levels[x] = level + 1;
+            levels[y] = level;
+
+            for (const auto f : moved) {
+                const auto [f0, f1]{std::pair{nodes[f].lo, nodes[f].hi}};
+                const auto [f00, f01]{nodes[f0].var == y ? std::pair{nodes[f0].lo, nodes[f0].hi} : std::pair{f0, f0}};
+                const auto [f10, f11]{nodes[f1].var == y ? std::pair{nodes[f1].lo, nodes[f1].hi} : std::pair{f1, f1}};
+
+                const auto lo{make(x, f00, f10)};
+                nodes[lo].refs++;
+                const auto hi{make(x, f01, f11)};
+                nodes[hi].refs++;
+
+                nodes[f] = {y, lo, hi, no_node, nodes[f].refs};
+                link(f);
+
+                for (const auto child : {f0, f1})
+                    if (child > one && --nodes[child].refs == 0)
+                        release(child);
+            }
+        }
+
+        /* Moves a variable through all levels and back to the best one */
+        void sift(uint32_t var) {
+            constexpr double max_growth{1.2};
+            const auto last_level{static_cast<uint32_t>(variables.size() - 1)};
+
+            auto best_size{size()};
+            auto best_level{levels[var]};
+
+            while (levels[var] < last_level && size() <= max_growth * best_size) {
+                swap_levels(levels[var]);
+                if (size() < best_size) {
+                    best_size = size();
+                    best_level = levels[var];
+                }
+            }
+            while (levels[var] > 0 && size() <= max_growth * best_size) {
+                swap_levels(levels[var] - 1);
+                if (size() < best_size) {
+                    best_size = size();
+                    best_level = levels[var];
+                }
+            }
+
+            while (levels[var] < best_level)
+                swap_levels(levels[var]);
+            while (levels[var] > best_level)
+                swap_levels(levels[var] - 1);
+        }
+
+        /* Assignments of variables from the level of a node down satisfying it */
+        const big_count& count_below(node_t f, std::unordered_map<node_t, big_count>& counts) const {
+            if (const auto known{counts.find(f)}; known != end(counts))
+                return known->second;
+
+            big_count result;
+            if (f == one) {
+                result.limbs = {1};
+            } else if (f != zero) {
+                const auto level{level_of(f)};
+                const auto& node{nodes[f]};
+                result = count_below(node.lo, counts).shifted(level_of(node.lo) - level - 1);
+                result += count_below(node.hi, counts).shifted(level_of(node.hi) - level - 1);
+            }
+            return counts.emplace(f, std::move(result)).first->second;
+        }
+
+        template<typename Visitor>
+        void visit_cubes(node_t f, std::vector<uint8_t>& cube, Visitor& visit) const {
+            if (f == zero)
+                return;
+            if (f == one) {
+                visit(cube);
+                return;
+            }
+
+            const auto& node{nodes[f]};
+            cube[node.var] = 0;
+            visit_cubes(node.lo, cube, visit);
+            cube[node.var] = 1;
+            visit_cubes(node.hi, cube, visit);
+            cube[node.var] = 2;
+        }
+
+        std::vector<node> nodes;
+        std::vector<node_t> free_nodes;
+        std::vector<unique_table> tables;
+        std::vector<uint32_t> levels;
+        std::vector<uint32_t> variables;
+        std::vector<cache_entry> cache;
+    };
+
+    /* Smallest number of nodes that triggers garbage collection and reordering */
+    constexpr size_t bdd_reorder_threshold{1 << 14};
+
+    bool print_bdd_outputs(const netlist& compiled, const options& settings, output_writer& output) {
+        const auto input_count{compiled.input_count};
+        bdd_manager manager{input_count};
+
+        /* Slots are released once no gate reads them and they are not displayed */
+        std::vector<uint32_t> readers(compiled.labels.size(), 0);
+        for (const auto input : compiled.fanins)
+            readers[input]++;
+        for (const auto slot : compiled.columns)
+            readers[slot]++;
+
+        std::vector<bdd_manager::node_t> functions(compiled.labels.size());
+        for (logic::slot_t slot{0}; slot < input_count; slot++) {
+            functions[slot] = manager.variable(slot);
+            manager.ref(functions[slot]);
+        }
+
+        auto limit{bdd_reorder_threshold};
+        for (const auto& gate : compiled.gates) {
+            const auto* const inputs{compiled.fanins.data() + gate.fanin_offset};
+            auto result{functions[inputs[0]]};
+
+            for (uint32_t i{1}; i < gate.fanin_count; i++) {
+                const auto input{functions[inputs[i]]};
+                switch (gate.op) {
+                    case logic::opcode::land:
+                    case logic::opcode::lnand:
+                        result = manager.conj(result, input);
+                        break;
+                    case logic::opcode::lor:
+                    case logic::opcode::lnor:
+                        result = manager.disj(result, input);
+                        break;
+                    default:
+                        result = manager.parity(result, input);
+                        break;
+                }
+            }
+            if (gate.op == logic::opcode::lnot || gate.op == logic::opcode::lnand || gate.op == logic::opcode::lnor)
+                result = manager.negate(result);
+
+            functions[gate.output] = result;
+            manager.ref(result);
+            for (uint32_t i{0}; i < gate.fanin_count; i++)
+                if (--readers[inputs[i]] == 0)
+                    manager.deref(functions[inputs[i]]);
+
+            if (manager.size() > limit) {
+                manager.collect_garbage();
+                if (manager.size() > limit / 2)
+                    manager.reorder();
+                limit = std::max(limit, 2 * manager.size());
+            }
+        }
+
+        /* Position of the value of slot i is that of its input by ascending identifier */
+        const auto format_values = [&](const std::vector<uint8_t>& values) {
+            std::string text(input_count, '-');
+            for (size_t slot{0}; slot < input_count; slot++)
+                if (values[slot] != 2)
+                    text[input_count - 1 - slot] = static_cast<char>('0' + values[slot]);
+            return text;
+        };
+
+        std::string buffer;
+        bool written{true};
+        for (size_t column{0}; column < compiled.columns.size(); column++) {
+            const auto label{std::to_string(compiled.column_labels[column])};
+            const auto function{functions[compiled.columns[column]]};
+
+            if (settings.bdd_query == "count") {
+                buffer += label + " " + manager.satisfy_count(function).to_string() + "\n";
+            } else if (settings.bdd_query == "sat") {
+                const auto assignment{manager.satisfying_assignment(function)};
+                buffer += label + " " + (assignment ? format_values(*assignment) : "none") + "\n";
+            } else {
+                manager.for_each_cube(function, [&](const std::vector<uint8_t>& cube) {
+                    buffer += label + " " + format_values(cube) + "\n";
+                    if (buffer.size() >= chunk_bytes) {
+                        written = written && output.write(buffer);
+                        buffer.clear();
+                    }
+                });
+            }
+        }
+
+        return written && output.write(buffer);
+    }
+
+    counter_group::counter_group(const std::vector<counted_event>& events, bool enabled, bool inherited) {
+        for (const auto& event : events) {
+            const auto leader{descriptors.empty() ? -1 : descriptors.front()};
+            descriptors.push_back(leader < 0 && !descriptors.empty() ? -1
+                                  : open_counter(event, leader, enabled, inherited));
+        }
+    }
+
+    counter_group::~counter_group() {
+        for (const auto descriptor : descriptors)
+            if (descriptor >= 0)
+                ::close(descriptor);
+    }
+
+    void counter_group::enable(bool enabled) const {
+        if (!descriptors.empty() && descriptors.front() >= 0)
+            ::ioctl(descriptors.front(), enabled ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE,
+                    PERF_IOC_FLAG_GROUP);
+    }
+
+    std::vector<std::optional<uint64_t>> counter_group::read() const {
+        std::vector<std::optional<uint64_t>> counts;
+        for (const auto descriptor : descriptors) {
+            /* Value, time enabled and time running */
+            std::array<uint64_t, 3> values{};
+            if (descriptor >= 0 && ::read(descriptor, values.data(), sizeof(values)) == sizeof(values)
+                && values[2] != 0)
+                counts.emplace_back(values[0]);
+            else
+                counts.emplace_back();
+        }
+        return counts;
+    }
+
+    int counter_group::open_counter(const counted_event& event, int leader, bool enabled, bool inherited) {
+        perf_event_attr attributes{};
+        attributes.type = event.type;
+        attributes.size = sizeof(attributes);
+        attributes.config = event.config;
+        attributes.disabled = leader < 0 && !enabled;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.inherit = inherited;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attributes, 0, -1, leader, 0));
+    }
+
+    memory_report::memory_report()
+            : counter{{{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+                       {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}}} {}
+
+    memory_report::~memory_report() {
+        rusage usage{};
+        ::getrusage(RUSAGE_SELF, &usage);
+        std::cerr << "Peak RSS: " << usage.ru_maxrss << " KiB." << std::endl;
+
+        const auto counts{counter.read()};
+        if (!counts[0] || !counts[1] || *counts[0] == 0) {
+            std::cerr << "Cache misses: unavailable." << std::endl;
+            return;
+        }
+
+        const auto references{*counts[0]};
+        const auto misses{*counts[1]};
+        const auto permille{misses * 1000 / references};
+        std::cerr << "Cache misses: " << misses << " of " << references << " references ("
+                  << permille / 10 << "." << permille % 10 << "%)." << std::endl;
+    }
+
+    perf_report::perf_report() {
+        counted_evaluations().enabled = true;
+    }
+
+    perf_report::~perf_report() {
+        const auto& stats{statistics()};
+        const auto rows{static_cast<double>(stats.rows.load())};
+        const auto evaluations{static_cast<double>(stats.gate_evaluations.load())};
+        this_thread_counters().flush();
+        auto& counted{counted_evaluations()};
+        const std::lock_guard lock{counted.mutex};
+        auto counts{counted.totals};
+        counts.resize(perf_event_names.size());
+
+        std::ostringstream report;
+        report << "Counter            total   per gate    per row\n";
+        for (size_t i{0}; i < counts.size(); i++) {
+            report << std::left << std::setw(14) << perf_event_names[i] << std::right;
+            if (!counts[i]) {
+                report << std::setw(11) << "unavailable" << "\n";
+                continue;
+            }
+            const auto count{static_cast<double>(*counts[i])};
+            report << std::setw(11) << *counts[i] << std::fixed << std::setprecision(4)
+                   << std::setw(11) << (evaluations > 0 ? count / evaluations : 0.0)
+                   << std::setw(11) << (rows > 0 ? count / rows : 0.0) << "\n";
+        }
+        if (counts[0] && counts[1] && *counts[0] != 0)
+            report << "Instructions per cycle: " << std::fixed << std::setprecision(2)
+                   << static_cast<double>(*counts[1]) / static_cast<double>(*counts[0]) << ".\n";
+        std::cerr << report.str() << std::flush;
+    }
+
+    stats_report::stats_report(bool json)
+            : json{json}, wall{clock_nanoseconds(CLOCK_MONOTONIC)}, cpu{clock_nanoseconds(CLOCK_PROCESS_CPUTIME_ID)} {
+        statistics().enabled = true;
+    }
+
+    stats_report::~stats_report() {
+        const auto& stats{statistics()};
+        const auto seconds = [](uint64_t nanoseconds) {
+            return static_cast<double>(nanoseconds) / 1e9;
+        };
+        const auto per_second = [](double count, double time) {
+            return time > 0 ? count / time : 0.0;
+        };
+
+        rusage usage{};
+        ::getrusage(RUSAGE_SELF, &usage);
+        const auto total_wall{seconds(clock_nanoseconds(CLOCK_MONOTONIC) - wall)};
+        const auto total_cpu{seconds(clock_nanoseconds(CLOCK_PROCESS_CPUTIME_ID) - cpu)};
+        const auto rows{stats.rows.load()};
+        const auto evaluations{static_cast<double>(stats.gate_evaluations.load())};
+        const auto evaluate_wall{seconds(stats.wall_nanoseconds[static_cast<size_t>(phase::evaluate)])};
+        const auto gate_rate{per_second(evaluations, evaluate_wall)};
+        const auto row_rate{per_second(static_cast<double>(rows), total_wall)};
+
+        std::ostringstream report;
+        report << std::fixed << std::setprecision(6);
+        if (json) {
+            report << "{\"phases\": {";
+            for (size_t i{0}; i < phase_names.size(); i++)
+                report << (i ? ", " : "") << "\"" << phase_names[i] << "\": {\"wall_seconds\": "
+                       << seconds(stats.wall_nanoseconds[i]) << ", \"cpu_seconds\": "
+                       << seconds(stats.cpu_nanoseconds[i]) << "}";
+            report << "}, \"total\": {\"wall_seconds\": " << total_wall << ", \"cpu_seconds\": "
+                   << total_cpu << "}, \"gates\": " << stats.gates << ", \"gates_evaluated\": "
+                   << std::setprecision(0) << evaluations << std::setprecision(6)
+                   << ", \"gates_evaluated_per_second\": " << gate_rate << ", \"rows\": " << rows
+                   << ", \"rows_per_second\": " << row_rate << ", \"bytes_written\": "
+                   << stats.bytes_written.load() << ", \"peak_rss_kib\": " << usage.ru_maxrss << "}\n";
+        } else {
+            report << "Phase        wall s      CPU s\n";
+            for (size_t i{0}; i < phase_names.size(); i++)
+                report << std::left << std::setw(9) << phase_names[i] << std::right << std::setw(10)
+                       << seconds(stats.wall_nanoseconds[i]) << std::setw(11)
+                       << seconds(stats.cpu_nanoseconds[i]) << "\n";
+            report << std::left << std::setw(9) << "total" << std::right << std::setw(10) << total_wall
+                   << std::setw(11) << total_cpu << "\n"
+                   << std::setprecision(0)
+                   << "Gates evaluated: " << evaluations << " (" << gate_rate << " per second).\n"
+                   << "Rows: " << rows << " (" << row_rate << " per second).\n"
+                   << "Bytes written: " << stats.bytes_written.load() << ".\n"
+                   << "Peak RSS: " << usage.ru_maxrss << " KiB.\n";
+        }
+        std::cerr << report.str() << std::flush;
+    }
+
+    std::optional<sigvector> parse_signal_list(std::string_view list) {
+        sigvector signals;
+
+        for (;;) {
+            const auto separator{std::min(list.find(','), list.size())};
+            const auto item{list.substr(0, separator)};
+
+            sig_t signal;
+            const auto [end, status]{std::from_chars(item.data(), item.data() + item.size(), signal)};
+            if (item.empty() || item.size() > signal_digits || item[0] == '0'
+                || status != std::errc{} || end != item.data() + item.size())
+                return std::nullopt;
+            signals.push_back(signal);
+
+            if (separator == list.size())
+                return signals;
+            list.remove_prefix(separator + 1);
+        }
+    }
+
+    std::optional<std::pair<uint64_t, uint64_t>> parse_number_pair(std::string_view text, char separator) {
+        std::pair<uint64_t, uint64_t> numbers;
+        const auto middle{text.find(separator)};
+        if (middle == std::string_view::npos)
+            return std::nullopt;
+
+        const auto* const text_end{text.data() + text.size()};
+        const auto [first_end, first_status]{std::from_chars(text.data(), text.data() + middle, numbers.first)};
+        const auto [second_end, second_status]{std::from_chars(text.data() + middle + 1, text_end, numbers.second)};
+        if (first_status != std::errc{} || first_end != text.data() + middle
+            || second_status != std::errc{} || second_end != text_end)
+            return std::nullopt;
+        return numbers;
+    }
+
+    std::optional<sigvector> select_signals(const gate_graph& circuit, const sigvector& labels) {
+        sigvector selection;
+
+        for (const auto label : labels) {
+            if (!circuit.indexes.contains(label)) {
+                error::print_unknown_signal_message(label);
+                return std::nullopt;
+            }
+            selection.push_back(circuit.indexes.at(label));
+        }
+
+        return selection;
+    }
+
+    /* Conflict-driven clause learning solver for formulas in conjunctive
+     * normal form. Literals are watched two per clause, decisions follow
+     * variable activities with saved phases, and the search restarts after
+     * conflict counts following the Luby sequence. */
+    class sat_solver {
+    public:
+        using lit_t = uint32_t;
+
+        static lit_t positive(uint32_t var) {
+            return 2 * var;
+        }
+
+        static lit_t negative(uint32_t var) {
+            return 2 * var + 1;
+        }
+
+        uint32_t new_variable() {
+            const auto var{static_cast<uint32_t>(assigns.size())};
+            assigns.push_back(unassigned);
+            phases.push_back(0);
+            levels.push_back(0);
+            reasons.push_back(no_reason);
+            activities.push_back(0);
+            seen.push_back(false);
+            heap_positions.push_back(no_position);
+            watchers.emplace_back();
+            watchers.emplace_back();
+            heap_insert(var);
+            return var;
+        }
+
+        /* Adds a clause before solving; literals already false are dropped */
+        void add_clause(std::vector<lit_t> literals) {
+            std::sort(begin(literals), end(literals));
+            literals.erase(std::unique(begin(literals), end(literals)), end(literals));
+
+            std::vector<lit_t> kept;
+            for (size_t i{0}; i < literals.size(); i++) {
+                if (i + 1 < literals.size() && literals[i + 1] == (literals[i] ^ 1))
+                    return;
+                if (value(literals[i]) == 1)
+                    return;
+                if (value(literals[i]) == unassigned)
+                    kept.push_back(literals[i]);
+            }
+
+            if (kept.empty()) {
+                inconsistent = true;
+            } else if (kept.size() == 1) {
+                enqueue(kept[0], no_reason);
+                inconsistent |= propagate() != no_reason;
+            } else {
+                attach(store(std::move(kept), false));
+            }
+        }
+
+        /* Decides satisfiability; on success the model is kept for value_of */
+        bool solve() {
+            if (inconsistent || propagate() != no_reason)
+                return false;
+
+            max_learnts = std::max<size_t>(clauses.size() / 3, 1000);
+            uint64_t restarts{0};
+
+            for (;;) {
+                const auto limit{restart_unit * luby(restarts++)};
+                const auto status{search(limit)};
+                if (status != unassigned)
+                    return status == 1;
+            }
+        }
+
+        bool value_of(uint32_t var) const {
+            return assigns[var] == 1;
+        }
+
+    private:
+        using clause_ref = uint32_t;
+
+        static constexpr int8_t unassigned{2};
+        static constexpr clause_ref no_reason{UINT32_MAX};
+        static constexpr uint32_t no_position{UINT32_MAX};
+        static constexpr uint64_t restart_unit{100};
+
+        struct clause {
+            std::vector<lit_t> literals;
+            double activity;
+            bool learnt;
+            bool deleted;
+        };
+
+        static uint64_t luby(uint64_t index) {
+            /* Finds the complete subsequence holding the index */
+            uint64_t size{1}, exponent{0};
+            while (size < index + 1) {
+                size = 2 * size + 1;
+                exponent++;
+            }
+            while (size - 1 != index) {
+                size = (size - 1) / 2;
+                exponent--;
+                index %= size;
+            }
+            return uint64_t{1} << exponent;
+        }
+
+        int8_t value(lit_t literal) const {
+            const auto assign{assigns[literal / 2]};
+            return assign == unassigned ? unassigned : static_cast<int8_t>(assign ^ (literal & 1));
+        }
+
+        uint32_t decision_level() const {
+            return static_cast<uint32_t>(trail_limits.size());
+        }
+
+        clause_ref store(std::vector<lit_t> literals, bool learnt) {
+            clauses.push_back({std::move(literals), 0, learnt, false});
+            return static_cast<clause_ref>(clauses.size() - 1);
+        }
+
+        void attach(clause_ref ref) {
+            const auto& literals{clauses[ref].literals};
+            watchers[literals[0]].push_back(ref);
+            watchers[literals[1]].push_back(ref);
+        }
+
+        void enqueue(lit_t literal, clause_ref reason) {
+            const auto var{literal / 2};
+            assigns[var] = static_cast<int8_t>(!(literal & 1));
+            levels[var] = decision_level();
+            reasons[var] = reason;
+            trail.push_back(literal);
+        }
+
+        /* Assigns the literals implied by the trail; returns a falsified clause */
+        clause_ref propagate() {
+            while (propagated < trail.size()) {
+                const auto falsified{trail[propagated++] ^ 1};
+                auto& watching{watchers[falsified]};
+                size_t kept{0};
+
+                for (size_t i{0}; i < watching.size(); i++) {
+                    const auto ref{watching[i]};
+                    auto& current{clauses[ref]};
+                    if (current.deleted)
+                        continue;
+
+                    auto& literals{current.literals};
+                    if (literals[0] == falsified)
+                        std::swap(literals[0], literals[1]);
+
+                    if (value(literals[0]) == 1) {
+                        watching[kept++] = ref;
+                        continue;
+                    }
+
+                    /* Look for a literal not yet false to watch instead */
+                    bool moved{false};
+                    for (size_t k{2}; k < literals.size(); k++) {
+                        if (value(literals[k]) != 0) {
+                            std::swap(literals[1], literals[k]);
+                            watchers[literals[1]].push_back(ref);
+                            moved = true;
+                            break;
+                        }
+                    }
+                    if (moved)
+                        continue;
+
+                    watching[kept++] = ref;
+                    if (value(literals[0]) == 0) {
+                        std::copy(begin(watching) + static_cast<ptrdiff_t>(i) + 1, end(watching),
+                                  begin(watching) + static_cast<ptrdiff_t>(kept));
+                        watching.resize(kept + watching.size() - i - 1);
+                        propagated = trail.size();
+                        return ref;
+                    }
+                    enqueue(literals[0], ref);
+                }
+                watching.resize(kept);
+            }
+            return no_reason;
+        }
+
+        /* Derives the first unique implication point clause of a conflict */
+        std::vector<lit_t> analyze(clause_ref conflict, uint32_t& backtrack_level) {
+            std::vector<lit_t> learnt{0};
+            size_t pending{0};
+            auto index{trail.size()};
+            std::optional<lit_t> implied;
+
+            do {
+                auto& reason{clauses[conflict]};
+                if (reason.learnt)
+                    bump_clause(reason);
+
+                for (size_t j{implied ? size_t{1} : size_t{0}}; j < reason.literals.size(); j++) {
+                    const auto literal{reason.literals[j]};
+                    const auto var{literal / 2};
+                    if (seen[var] || levels[var] == 0)
+                        continue;
+
+                    seen[var] = true;
+                    bump_variable(var);
+                    if (levels[var] == decision_level())
+                        pending++;
+                    else
+                        learnt.push_back(literal);
+                }
+
+                while (!seen[trail[--index] / 2]);
+                implied = trail[index];
+                conflict = reasons[*implied / 2];
+                seen[*implied / 2] = false;
+            } while (--pending > 0);
+
+            learnt[0] = *implied ^ 1;
+            for (size_t j{1}; j < learnt.size(); j++)
+                seen[learnt[j] / 2] = false;
+
+            /* The literal of the deepest remaining level is watched second */
+            backtrack_level = 0;
+            for (size_t j{1}; j < learnt.size(); j++) {
+                if (levels[learnt[j] / 2] > backtrack_level) {
+                    backtrack_level = levels[learnt[j] / 2];
+                    std::swap(learnt[1], learnt[j]);
+                }
+            }
+            return learnt;
+        }
+
+        void cancel_until(uint32_t level) {
+            if (decision_level() <= level)
+                return;
+
+            for (auto i{trail.size()}; i > trail_limits[level]; i--) {
+                const auto var{trail[i - 1] / 2};
+                phases[var] = assigns[var];
+                assigns[var] = unassigned;
+                reasons[var] = no_reason;
+                heap_insert(var);
+            }
+            trail.resize(trail_limits[level]);
+            trail_limits.resize(level);
+            propagated = trail.size();
+        }
+
+        /* Searches until a model, a refutation or a number of conflicts */
+        int8_t search(uint64_t conflict_limit) {
+            for (uint64_t conflicts{0};;) {
+                const auto conflict{propagate()};
+
+                if (conflict != no_reason) {
+                    conflicts++;
+                    if (decision_level() == 0)
+                        return 0;
+
+                    uint32_t backtrack_level;
+                    auto learnt{analyze(conflict, backtrack_level)};
+                    cancel_until(backtrack_level);
+
+                    if (learnt.size() == 1) {
+                        enqueue(learnt[0], no_reason);
+                    } else {
+                        const auto ref{store(std::move(learnt), true)};
+                        attach(ref);
+                        bump_clause(clauses[ref]);
+                        learnt_count++;
+                        enqueue(clauses[ref].literals[0], ref);
+                    }
+
+                    variable_increment /= variable_decay;
+                    clause_increment /= clause_decay;
+                    continue;
+                }
+
+                if (conflicts >= conflict_limit) {
+                    cancel_until(0);
+                    return unassigned;
+                }
+                if (learnt_count >= max_learnts + trail.size())
+                    reduce_learnts();
+
+                const auto var{pick_branch_variable()};
+                if (!var)
+                    return 1;
+
+                trail_limits.push_back(trail.size());
+                enqueue(phases[*var] == 1 ? positive(*var) : negative(*var), no_reason);
+            }
+        }
+
+        /* Deletes the less active half of learnt clauses not serving as reasons */
+        void reduce_learnts() {
+            std::vector<clause_ref> candidates;
+            for (clause_ref ref{0}; ref < clauses.size(); ref++) {
+                const auto& current{clauses[ref]};
+                if (!current.learnt || current.deleted || current.literals.size() <= 2)
+                    continue;
+                const auto var{current.literals[0] / 2};
+                if (reasons[var] == ref && value(current.literals[0]) == 1)
+                    continue;
+                candidates.push_back(ref);
+            }
+
+            std::sort(begin(candidates), end(candidates), [&](clause_ref lhs, clause_ref rhs) {
+                return clauses[lhs].activity < clauses[rhs].activity;
+            });
+            for (size_t i{0}; i < candidates.size() / 2; i++) {
+                auto& current{clauses[candidates[i]]};
+                current.deleted = true;
+                current.literals = {};
+                learnt_count--;
+            }
+            max_learnts += max_learnts / 10;
+        }
+
+        void bump_variable(uint32_t var) {
+            if ((activities[var] += variable_increment) > 1e100) {
+                for (auto& activity : activities)
+                    activity *= 1e-100;
+                variable_increment *= 1e-100;
+            }
+            if (heap_positions[var] != no_position)
+                heap_up(heap_positions[var]);
+        }
+
+        void bump_clause(clause& current) {
+            if ((current.activity += clause_increment) > 1e20) {
+                for (auto& other : clauses)
+                    if (other.learnt)
+                        other.activity *= 1e-20;
+                clause_increment *= 1e-20;
+            }
+        }
+
+        std::optional<uint32_t> pick_branch_variable() {
+            while (!heap.empty()) {
+                const auto var{heap.front()};
+                heap_remove_top();
+                if (assigns[var] == unassigned)
+                    return var;
+            }
+            return std::nullopt;
+        }
+
+        /* Binary max-heap of variables ordered by activity */
+        void heap_insert(uint32_t var) {
+            if (heap_positions[var] != no_position)
+                return;
+            heap_positions[var] = static_cast<uint32_t>(heap.size());
+            heap.push_back(var);
+            heap_up(heap_positions[var]);
+        }
+
+        void heap_remove_top() {
+            heap_positions[heap.front()] = no_position;
+            heap.front() = heap.back();
+            heap.pop_back();
+            if (!heap.empty()) {
+                heap_positions[heap.front()] = 0;
+                heap_down(0);
+            }
+        }
+
+        void heap_up(uint32_t position) {
+            const auto var{heap[position]};
+            while (position > 0) {
+                const auto parent{(position - 1) / 2};
+                if (activities[heap[parent]] >= activities[var])
+                    break;
+                heap[position] = heap[parent];
+                heap_positions[heap[position]] = position;
+                position = parent;
+            }
+            heap[position] = var;
+            heap_positions[var] = position;
+        }
+
+        void heap_down(uint32_t position) {
+            const auto var{heap[position]};
+            for (;;) {
+                auto child{2 * position + 1};
+                if (child >= heap.size())
+                    break;
+                if (child + 1 < heap.size() && activities[heap[child + 1]] > activities[heap[child]])
+                    child++;
+                if (activities[heap[child]] <= activities[var])
+                    break;
+                heap[position] = heap[child];
+                heap_positions[heap[position]] = position;
+                position = child;
+            }
+            heap[position] = var;
+            heap_positions[var] = position;
+        }
+
+        std::vector<clause> clauses;
+        std::vector<std::vector<clause_ref>> watchers;
+        std::vector<int8_t> assigns;
+        std::vector<int8_t> phases;
+        std::vector<uint32_t> levels;
+        std::vector<clause_ref> reasons;
+        std::vector<double> activities;
+        std::vector<bool> seen;
+        std::vector<uint32_t> heap;
+        std::vector<uint32_t> heap_positions;
+        std::vector<lit_t> trail;
+        std::vector<size_t> trail_limits;
+        size_t propagated{0};
+        size_t learnt_count{0};
+        size_t max_learnts{0};
+        double variable_increment{1};
+        double clause_increment{1};
+        static constexpr double variable_decay{0.95};
+        static constexpr double clause_decay{0.999};
+        bool inconsistent{false};
+    };
+
+    /* Adds clauses forcing a variable to the value of a gate over other variables */
+    void encode_gate(sat_solver& solver, logic::opcode op, uint32_t output, const std::vector<uint32_t>& inputs) {
+        using lit_t = sat_solver::lit_t;
+        const auto pos{sat_solver::positive};
+        const auto neg{sat_solver::negative};
+
+        switch (op) {
+            case logic::opcode::lnot:
+                solver.add_clause({pos(output), pos(inputs[0])});
+                solver.add_clause({neg(output), neg(inputs[0])});
+                return;
+            case logic::opcode::lxor:
+                solver.add_clause({neg(output), pos(inputs[0]), pos(inputs[1])});
+                solver.add_clause({neg(output), neg(inputs[0]), neg(inputs[1])});
+                solver.add_clause({pos(output), neg(inputs[0]), pos(inputs[1])});
+                solver.add_clause({pos(output), pos(inputs[0]), neg(inputs[1])});
+                return;
+            default:
+                break;
+        }
+
+        /* Conjunctions and disjunctions, possibly negated: y = ~x1 op ... */
+        const auto conjunction{op == logic::opcode::land || op == logic::opcode::lnand};
+        const auto negated{op == logic::opcode::lnand || op == logic::opcode::lnor};
+        const auto result{negated ? neg(output) : pos(output)};
+
+        /* For a conjunction: y implies every input, all inputs imply y */
+        std::vector<lit_t> complete{conjunction ? result : result ^ 1};
+        for (const auto input : inputs) {
+            solver.add_clause({conjunction ? result ^ 1 : result, conjunction ? pos(input) : neg(input)});
+            complete.push_back(conjunction ? neg(input) : pos(input));
+        }
+        solver.add_clause(std::move(complete));
+    }
+
+    /* Encodes all gates of a compiled circuit, inputs taking the given variables;
+     * returns the variable of every slot */
+    std::vector<uint32_t> encode_circuit(sat_solver& solver, const netlist& compiled,
+                                         const std::vector<size_t>& input_of,
+                                         const std::vector<uint32_t>& input_variables) {
+        std::vector<uint32_t> variables(compiled.labels.size());
+        for (size_t slot{0}; slot < compiled.input_count; slot++)
+            variables[slot] = input_variables[input_of[slot]];
+
+        std::vector<uint32_t> inputs;
+        for (const auto& gate : compiled.gates) {
+            inputs.clear();
+            for (uint32_t i{0}; i < gate.fanin_count; i++)
+                inputs.push_back(variables[compiled.fanins[gate.fanin_offset + i]]);
+
+            variables[gate.output] = solver.new_variable();
+            encode_gate(solver, gate.op, variables[gate.output], inputs);
+        }
+
+        return variables;
+    }
+
+    /* Reads and parses a netlist file, reporting errors of its lines */
+    std::optional<gate_graph> read_netlist(const std::string& path, size_t thread_count) {
+        const mapped_file mapping{path};
+        if (!mapping.is_open()) {
+            error::print_netlist_file_message(path);
+            return std::nullopt;
+        }
+
+        gate_graph circuit;
+        if (!parse_netlist(mapping.text(), thread_count, circuit)) {
+            error::print_invalid_netlist_message(path);
+            return std::nullopt;
+        }
+        return circuit;
+    }
+
+    /* Identifiers of gates no other gate reads, by ascending order */
+    sigvector get_primary_outputs(const gate_graph& circuit) {
+        std::vector<bool> read(circuit.size(), false);
+        for (sig_t signal{0}; signal < static_cast<sig_t>(circuit.size()); signal++)
+            if (circuit.contains(signal))
+                for (const auto input : circuit.at(signal).second)
+                    read[input] = true;
+
+        sigvector labels;
+        for (sig_t signal{0}; signal < static_cast<sig_t>(circuit.size()); signal++)
+            if (circuit.contains(signal) && !read[signal])
+                labels.push_back(circuit.labels[signal]);
+        std::sort(begin(labels), end(labels));
+        return labels;
+    }
+
+    /* Number of random blocks simulated before turning to the SAT solver */
+    constexpr size_t equivalence_rounds{64};
+
+    int check_equivalence(const options& settings, output_writer& output) {
+        const auto first{read_netlist(settings.operands[0], settings.threads)};
+        if (!first)
+            return EXIT_FAILURE;
+        const auto second{read_netlist(settings.operands[1], settings.threads)};
+        if (!second)
+            return EXIT_FAILURE;
+
+        auto compared{settings.outputs ? *settings.outputs : get_primary_outputs(*first)};
+        if (!settings.outputs && compared != get_primary_outputs(*second)) {
+            error::print_different_outputs_message();
+            return EXIT_FAILURE;
+        }
+
+        const auto selection_a{select_signals(*first, compared)};
+        if (!selection_a)
+            return EXIT_FAILURE;
+        const auto selection_b{select_signals(*second, compared)};
+        if (!selection_b)
+            return EXIT_FAILURE;
+
+        const std::array compiled{prepare_circuit(*first, selection_a, settings),
+                                  prepare_circuit(*second, selection_b, settings)};
+
+        /* Inputs of both netlists by ascending identifier */
+        sigvector inputs;
+        for (const auto& netlist : compiled)
+            inputs.insert(end(inputs), begin(netlist.labels), std::next(begin(netlist.labels),
+                          static_cast<ptrdiff_t>(netlist.input_count)));
+        std::sort(begin(inputs), end(inputs));
+        inputs.erase(std::unique(begin(inputs), end(inputs)), end(inputs));
+
+        std::array<std::vector<size_t>, 2> input_of;
+        for (size_t side{0}; side < 2; side++) {
+            const auto& netlist{compiled[side]};
+            for (size_t slot{0}; slot < netlist.labels.size(); slot++) {
+                const auto position{std::lower_bound(begin(inputs), end(inputs), netlist.labels[slot])};
+                const auto is_input{position != end(inputs) && *position == netlist.labels[slot]};
+                if (slot < netlist.input_count) {
+                    input_of[side].push_back(static_cast<size_t>(position - begin(inputs)));
+                } else if (is_input) {
+                    error::print_input_mismatch_message(netlist.labels[slot]);
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+
+        std::array<std::vector<logic::binblock>, 2> values{
+                std::vector<logic::binblock>(compiled[0].labels.size()),
+                std::vector<logic::binblock>(compiled[1].labels.size())};
+
+        const auto simulate = [&](const std::vector<logic::binblock>& stimuli) {
+            for (size_t side{0}; side < 2; side++) {
+                for (size_t slot{0}; slot < compiled[side].input_count; slot++)
+                    values[side][slot] = stimuli[input_of[side][slot]];
+                compute_gates(compiled[side], values[side]);
+            }
+        };
+
+        /* Lane in which the compared signals differ, if any */
+        const auto find_difference = [&]() -> std::optional<size_t> {
+            for (size_t column{0}; column < compared.size(); column++) {
+                const auto& lhs{values[0][compiled[0].columns[column]]};
+                const auto& rhs{values[1][compiled[1].columns[column]]};
+                for (size_t word{0}; word < logic::block_words; word++)
+                    if (const auto difference{lhs[word] ^ rhs[word]}; difference != 0)
+                        return word * word_lanes + static_cast<size_t>(std::countr_zero(difference));
+            }
+            return std::nullopt;
+        };
+
+        std::vector<logic::binblock> stimuli(inputs.size());
+        std::optional<std::vector<uint8_t>> counterexample;
+        uint64_t state{0x243F6A8885A308D3};
+
+        for (size_t round{0}; round < equivalence_rounds && !counterexample; round++) {
+            for (auto& block : stimuli)
+                for (auto& word : block) {
+                    /* Steps of the splitmix64 generator */
+                    auto mixed{state += 0x9E3779B97F4A7C15};
+                    mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9;
+                    mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EB;
+                    word = mixed ^ (mixed >> 31);
+                }
+
+            simulate(stimuli);
+            if (const auto lane{find_difference()}) {
+                counterexample.emplace();
+                for (const auto& block : stimuli)
+                    counterexample->push_back((block[*lane / word_lanes] >> (*lane % word_lanes)) & 1);
+            }
+        }
+
+        if (!counterexample) {
+            sat_solver solver;
+            std::vector<uint32_t> input_variables(inputs.size());
+            std::generate(begin(input_variables), end(input_variables), [&] { return solver.new_variable(); });
+
+            std::array<std::vector<uint32_t>, 2> variables;
+            for (size_t side{0}; side < 2; side++)
+                variables[side] = encode_circuit(solver, compiled[side], input_of[side], input_variables);
+
+            /* The miter is satisfied when any pair of compared signals differs */
+            std::vector<sat_solver::lit_t> miter;
+            for (size_t column{0}; column < compared.size(); column++) {
+                const auto lhs{variables[0][compiled[0].columns[column]]};
+                const auto rhs{variables[1][compiled[1].columns[column]]};
+                const auto difference{solver.new_variable()};
+                encode_gate(solver, logic::opcode::lxor, difference, {lhs, rhs});
+                miter.push_back(sat_solver::positive(difference));
+            }
+            solver.add_clause(std::move(miter));
+
+            if (solver.solve()) {
+                counterexample.emplace();
+                for (const auto var : input_variables)
+                    counterexample->push_back(solver.value_of(var));
+            }
+        }
+
+        std::string report;
+        if (!counterexample) {
+            report = "equivalent\n";
+        } else {
+            /* Replays the counterexample to name the signals that differ */
+            for (size_t input{0}; input < inputs.size(); input++)
+                stimuli[input].fill((*counterexample)[input] ? ~logic::binword{0} : 0);
+            simulate(stimuli);
+
+            report = "not equivalent\ninputs";
+            for (const auto label : inputs)
+                report += " " + std::to_string(label);
+            report += "\ncounterexample ";
+            for (const auto value : *counterexample)
+                report += static_cast<char>('0' + value);
+            report += "\ndiffering outputs";
+            for (size_t column{0}; column < compared.size(); column++)
+                if ((values[0][compiled[0].columns[column]][0] ^ values[1][compiled[1].columns[column]][0]) & 1)
+                    report += " " + std::to_string(compared[column]);
+            report += "\n";
+        }
+        if (!output.write(report))
+            return EXIT_FAILURE;
+
+        return counterexample ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    int merge_range_outputs(const options& settings) {
+        std::deque<mapped_file> files;
+        std::vector<std::string_view> bodies;
+        std::optional<range_header> previous;
+
+        /* An output file is written aside and renamed once complete */
+        const auto temporary{settings.output ? *settings.output + ".tmp" : std::string{}};
+        const auto same_file = [](const std::string& path, const std::string& other) {
+            struct stat status{}, other_status{};
+            return path == other || (::stat(path.c_str(), &status) == 0 && ::stat(other.c_str(), &other_status) == 0
+                                     && status.st_dev == other_status.st_dev && status.st_ino == other_status.st_ino);
+        };
+
+        for (const auto& path : settings.operands) {
+            if (settings.output && (same_file(path, *settings.output) || same_file(path, temporary))) {
+                error::print_range_file_message(path, "is also the output");
+                return EXIT_FAILURE;
+            }
+
+            const auto& file{files.emplace_back(path)};
+            if (!file.is_open()) {
+                error::print_output_file_message(path);
+                return EXIT_FAILURE;
+            }
+
+            const auto text{file.text()};
+            const auto line_end{std::min(text.find('\n'), text.size())};
+            const auto header{parse_range_header(text.substr(0, line_end + 1))};
+            if (!header) {
+                error::print_range_file_message(path, "has no range header");
+                return EXIT_FAILURE;
+            }
+            if (previous && (header->combinations != previous->combinations
+                             || header->netlist_hash != previous->netlist_hash)) {
+                error::print_range_file_message(path, "belongs to another netlist");
+                return EXIT_FAILURE;
+            }
+            const auto expected{previous ? previous->last : 0};
+            if (header->first != expected) {
+                error::print_range_file_message(path, "does not start at combination " + std::to_string(expected));
+                return EXIT_FAILURE;
+            }
+
+            const auto body{text.substr(line_end + 1)};
+            if (static_cast<uint64_t>(std::count(begin(body), end(body), '\n')) != header->last - header->first
+                || (!body.empty() && body.back() != '\n')) {
+                error::print_range_file_message(path, "is incomplete");
+                return EXIT_FAILURE;
+            }
+
+            bodies.push_back(body);
+            previous = header;
+        }
+
+        if (!previous || previous->last != previous->combinations) {
+            error::print_missing_range_message(previous ? previous->last : 0, previous ? previous->combinations : 0);
+            return EXIT_FAILURE;
+        }
+
+        auto output{settings.output ? output_writer{temporary} : output_writer{}};
+        if (!output.is_open()) {
+            error::print_output_file_message(temporary);
+            return EXIT_FAILURE;
+        }
+
+        auto written{std::all_of(begin(bodies), end(bodies), [&](std::string_view body) {
+            return output.write(body);
+        })};
+        if (settings.output) {
+            if (written && !output.sync()) {
+                error::print_output_write_message();
+                written = false;
+            }
+            if (written && ::rename(temporary.c_str(), settings.output->c_str()) != 0) {
+                error::print_output_file_message(*settings.output);
+                written = false;
+            }
+            if (!written)
+                ::unlink(temporary.c_str());
+        }
+        return written ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+}